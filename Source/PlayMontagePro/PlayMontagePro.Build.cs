@@ -24,6 +24,7 @@ public class PlayMontagePro : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"TraceLog",
 			}
 			);
 
@@ -1,6 +1,7 @@
 // Copyright (c) Jared Taylor
 
 #include "Ability/AbilityTask_PlayMontageProAndWait.h"
+#include "PlayMontageProSubsystem.h"
 #include "Animation/AnimMontage.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/Character.h"
@@ -19,7 +20,7 @@ static FAutoConsoleVariableRef CVarPlayMontageProAndWaitFireInterruptOnAnimEndIn
 void UAbilityTask_PlayMontageProAndWait::OnMontageBlendingOut(UAnimMontage* Montage, bool bInterrupted)
 {
 	UPlayMontageProStatics::EnsureBroadcastNotifyEvents(
-		bInterrupted ? EAnimNotifyProEventType::OnInterrupted : EAnimNotifyProEventType::BlendOut, Notifies, NotifyStatePairs, this);
+		bInterrupted ? EAnimNotifyProEventType::OnInterrupted : EAnimNotifyProEventType::BlendOut, this);
 	
 	const bool bPlayingThisMontage = (Montage == MontageToPlay) && Ability && Ability->GetCurrentMontage() == MontageToPlay;
 	if (bPlayingThisMontage)
@@ -70,7 +71,7 @@ void UAbilityTask_PlayMontageProAndWait::OnMontageBlendedIn(UAnimMontage* Montag
 
 void UAbilityTask_PlayMontageProAndWait::OnGameplayAbilityCancelled()
 {
-	UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnInterrupted, Notifies, NotifyStatePairs, this);
+	UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnInterrupted, this);
 
 	if (StopPlayingMontage() || bAllowInterruptAfterBlendOut)
 	{
@@ -91,7 +92,7 @@ void UAbilityTask_PlayMontageProAndWait::OnGameplayAbilityCancelled()
 void UAbilityTask_PlayMontageProAndWait::OnMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 {
 	UPlayMontageProStatics::EnsureBroadcastNotifyEvents(
-		bInterrupted ? EAnimNotifyProEventType::OnInterrupted : EAnimNotifyProEventType::OnCompleted, Notifies, NotifyStatePairs, this);
+		bInterrupted ? EAnimNotifyProEventType::OnInterrupted : EAnimNotifyProEventType::OnCompleted, this);
 
 	if (!bInterrupted)
 	{
@@ -178,36 +179,44 @@ void UAbilityTask_PlayMontageProAndWait::Activate()
 
 				// -- PlayMontagePro --
 				
-				// Use the mesh comp's OnTickPose to detect time dilation changes
-				if (bEnableCustomTimeDilation && GetMesh() && ActorInfo->AvatarActor.IsValid())
+				// Timelines are owned by the world's subsystem, we only keep a handle
+				// The timeline follows the avatar's time dilation, changes are pushed by UPlayMontageProSubsystem::NotifyTimeDilationChanged
+				AActor* TimeDilationActor = bEnableCustomTimeDilation ? ActorInfo->AvatarActor.Get() : nullptr;
+				if (FAnimNotifyProTimeline* Timeline = UPlayMontageProSubsystem::AcquireTimeline(GetWorld(), this, this, TimelineHandle, TimeDilationActor, MontageToPlay))
 				{
-					TimeDilation = ActorInfo->AvatarActor->CustomTimeDilation;
-					TickPoseHandle = GetMesh()->OnTickPose.AddUObject(this, &ThisClass::OnTickPose);
+					// Notify times are in montage time, the timeline's clock runs at the play rate
+					Timeline->PlayRate = Rate;
+
+					// Polling the mesh comp's OnTickPose for time dilation set directly on the actor is opt-in
+					if (TimeDilationActor && GetMesh() && UPlayMontageProStatics::ShouldPollTimeDilation())
+					{
+						TickPoseHandle = GetMesh()->OnTickPose.AddUObject(this, &ThisClass::OnTickPose);
+					}
+
+					if (StartSection != NAME_None)
+					{
+						// PlayMontagePro needs to update StartingPosition to account for the section jump
+						const float NewPosition = AnimInstance->Montage_GetPosition(MontageToPlay);
+						StartTimeSeconds += (NewPosition - StartTimeSeconds);
+					}
+
+					// Handle section changes
+					AnimInstance->OnMontageSectionChanged.AddDynamic(this, &ThisClass::OnMontageSectionChanged);
+
+					// Notify trigger chances are rolled from the activation's prediction key, so the server and the predicting client agree
+					const FPredictionKey PredictionKey = Ability->GetCurrentActivationInfo().GetActivationPredictionKey();
+					Timeline->TriggerSeed = PredictionKey.IsValidKey() ? static_cast<uint32>(PredictionKey.Current) : static_cast<uint32>(FMath::Rand());
+
+					// Gather notifies from montage
+					const FName Section = AnimInstance->Montage_GetCurrentSection(MontageToPlay);
+					UPlayMontageProStatics::GatherNotifies(this, MontageToPlay, *Timeline, Section, StartTimeSeconds);
+
+					// Trigger notifies before start time and remove them, if we want to trigger them before the start time
+					UPlayMontageProStatics::HandleHistoricNotifies(*Timeline, bTriggerNotifiesBeforeStartTime, this);
+
+					// Create timer delegates for notifies
+					UPlayMontageProStatics::SetupNotifyTimers(this, GetWorld(), *Timeline);
 				}
-				else
-				{
-					TimeDilation = 1.f;
-				}
-
-				if (StartSection != NAME_None)
-				{
-					// PlayMontagePro needs to update StartingPosition to account for the section jump
-					const float NewPosition = AnimInstance->Montage_GetPosition(MontageToPlay);
-					StartTimeSeconds += (NewPosition - StartTimeSeconds);
-				}
-
-				// Handle section changes
-				AnimInstance->OnMontageSectionChanged.AddDynamic(this, &ThisClass::OnMontageSectionChanged);
-
-				// Gather notifies from montage
-				const FName Section = AnimInstance->Montage_GetCurrentSection(MontageToPlay);
-				UPlayMontageProStatics::GatherNotifies(this, MontageToPlay, NotifyId, Notifies, NotifyStatePairs, Section, StartTimeSeconds, TimeDilation);
-
-				// Trigger notifies before start time and remove them, if we want to trigger them before the start time
-				UPlayMontageProStatics::HandleHistoricNotifies(Notifies, NotifyStatePairs, bTriggerNotifiesBeforeStartTime, StartTimeSeconds, this);
-
-				// Create timer delegates for notifies
-				UPlayMontageProStatics::SetupNotifyTimers(this, GetWorld(), Notifies);
 			}
 		}
 		else
@@ -223,7 +232,7 @@ void UAbilityTask_PlayMontageProAndWait::Activate()
 	if (!bPlayedMontage)
 	{
 		ABILITY_LOG(Warning, TEXT("UAbilityTask_PlayMontageProAndWait called in Ability %s failed to play montage %s; Task Instance Name %s."), *Ability->GetName(), *GetNameSafe(MontageToPlay),*InstanceName.ToString());
-		UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnCancelled, Notifies, NotifyStatePairs, this);
+		UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnCancelled, this);
 		if (ShouldBroadcastAbilityTaskDelegates())
 		{
 			OnCancelled.Broadcast();
@@ -235,7 +244,7 @@ void UAbilityTask_PlayMontageProAndWait::Activate()
 
 void UAbilityTask_PlayMontageProAndWait::ExternalCancel()
 {
-	UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnCancelled, Notifies, NotifyStatePairs, this);
+	UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnCancelled, this);
 	if (ShouldBroadcastAbilityTaskDelegates())
 	{
 		OnCancelled.Broadcast();
@@ -270,27 +279,29 @@ void UAbilityTask_PlayMontageProAndWait::OnMontageSectionChanged(UAnimMontage* I
 		return;
 	}
 
-	const float StartTime = AnimInstance->Montage_GetPosition(InMontage);
-
-	// End previous notify timers
-	UPlayMontageProStatics::ClearNotifyTimers(GetWorld(), Notifies);
-
-	// Gather notifies from montage
-	UPlayMontageProStatics::GatherNotifies(this, InMontage, NotifyId, Notifies, NotifyStatePairs, SectionName, StartTime, TimeDilation);
+	FAnimNotifyProTimeline* Timeline = GetTimeline();
+	if (!Timeline)
+	{
+		return;
+	}
 
-	// Create timer delegates for notifies
-	UPlayMontageProStatics::SetupNotifyTimers(this, GetWorld(), Notifies);
+	// Every section was gathered when the montage started, so we only move to the new position
+	UPlayMontageProStatics::HandleSectionChange(this, GetWorld(), *Timeline, AnimInstance->Montage_GetPosition(InMontage), bLooped);
 }
 
 void UAbilityTask_PlayMontageProAndWait::OnTickPose(USkinnedMeshComponent* SkinnedMeshComponent, float DeltaTime,
 	bool NeedsValidRootMotion)
 {
-	UPlayMontageProStatics::HandleTimeDilation(this, SkinnedMeshComponent, TimeDilation, Notifies);
+	if (FAnimNotifyProTimeline* Timeline = GetTimeline())
+	{
+		UPlayMontageProStatics::HandleTimeDilation(this, SkinnedMeshComponent, *Timeline);
+	}
 }
 
 void UAbilityTask_PlayMontageProAndWait::OnDestroy(bool AbilityEnded)
 {
-	UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnCompleted, Notifies, NotifyStatePairs, this);
+	UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnCompleted, this);
+	UPlayMontageProSubsystem::ReleaseTimeline(TimelineHandle);
 	
 	if (TickPoseHandle.IsValid() && GetMesh())
 	{
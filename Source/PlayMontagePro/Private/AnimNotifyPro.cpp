@@ -2,8 +2,10 @@
 
 
 #include "AnimNotifyPro.h"
+#include "PlayMontageProStatics.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Animation/AnimMontage.h"
+#include "UObject/UObjectIterator.h"
 
 #if WITH_EDITOR
 #include "Animation/DebugSkelMeshComponent.h"
@@ -14,22 +16,58 @@
 
 UAnimNotifyPro::UAnimNotifyPro(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, bHasNativeOnNotify(false)
+	, bHasBlueprintOnNotify(false)
+	, bCapabilitiesCached(false)
 {
 #if WITH_EDITORONLY_DATA
 	// Pale yellow color
 	NotifyColor = FColor(255, 255, 200);
-	
-	auto ImplementedInBlueprint = [](const UFunction* Func) -> bool
+#endif
+}
+
+const UAnimNotifyPro* UAnimNotifyPro::GetClassCapabilities() const
+{
+	// Not looked up in the constructor, a Blueprint's default object is constructed before its functions are compiled
+	UAnimNotifyPro* ClassDefault = GetClass()->GetDefaultObject<UAnimNotifyPro>();
+	if (!ClassDefault->bCapabilitiesCached)
 	{
-		return Func && ensure(Func->GetOuter())
-			&& Func->GetOuter()->IsA(UBlueprintGeneratedClass::StaticClass());
-	};
+		ClassDefault->CacheClassCapabilities();
+	}
+	return ClassDefault;
+}
 
+void UAnimNotifyPro::InvalidateClassCapabilities()
+{
+	for (TObjectIterator<UClass> It; It; ++It)
 	{
-		static FName FuncName = FName(TEXT("Received_Notify"));
-		const UFunction* BPFunc = GetClass()->FindFunctionByName(FuncName);
-		bHasBlueprintReceivedNotify = ImplementedInBlueprint(BPFunc);
+		if (It->IsChildOf(StaticClass()))
+		{
+			if (UAnimNotifyPro* ClassDefault = Cast<UAnimNotifyPro>(It->GetDefaultObject(false)))
+			{
+				ClassDefault->bCapabilitiesCached = false;
+			}
+		}
 	}
+}
+
+void UAnimNotifyPro::CacheClassCapabilities()
+{
+	const UClass* Class = GetClass();
+
+	// Blueprints can't override OnNotify, only a native class between this one and the class can
+	const UClass* NativeClass = Class;
+	while (NativeClass && !NativeClass->HasAnyClassFlags(CLASS_Native))
+	{
+		NativeClass = NativeClass->GetSuperClass();
+	}
+	bHasNativeOnNotify = NativeClass != UAnimNotifyPro::StaticClass();
+	bHasBlueprintOnNotify = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UAnimNotifyPro, K2_OnNotify));
+	bCapabilitiesCached = true;
+
+#if WITH_EDITORONLY_DATA
+	static FName FuncName = FName(TEXT("Received_Notify"));
+	bHasBlueprintReceivedNotify = Class->IsFunctionImplementedInScript(FuncName);
 #endif
 }
 
@@ -38,7 +76,7 @@ UAnimNotifyPro::UAnimNotifyPro(const FObjectInitializer& ObjectInitializer)
 EDataValidationResult UAnimNotifyPro::IsDataValid(class FDataValidationContext& Context) const
 {
 #if WITH_EDITORONLY_DATA
-	if (bHasBlueprintReceivedNotify)
+	if (GetClassCapabilities()->bHasBlueprintReceivedNotify)
 	{
 		Context.AddError(
 			FText::Format(
@@ -54,6 +92,14 @@ EDataValidationResult UAnimNotifyPro::IsDataValid(class FDataValidationContext&
 	return Super::IsDataValid(Context);
 }
 
+void UAnimNotifyPro::PostCDOCompiled(const FPostCDOCompiledContext& Context)
+{
+	Super::PostCDOCompiled(Context);
+
+	// The Blueprint's functions may have changed
+	bCapabilitiesCached = false;
+}
+
 #endif
 
 void UAnimNotifyPro::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation,
@@ -64,7 +110,7 @@ void UAnimNotifyPro::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase*
 	if (MeshComp->IsA<UDebugSkelMeshComponent>() && ShouldFireInEditor())
 	{
 		UAnimMontage* Montage = Animation ? Cast<UAnimMontage>(Animation) : nullptr;
-		OnNotify(MeshComp, Montage);
+		OnNotify(MeshComp, Montage, UPlayMontageProStatics::MakeLegacyNotifyContext(MeshComp, Montage, EventReference));
 	}
 #endif
 
@@ -75,7 +121,7 @@ void UAnimNotifyPro::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase*
 		{
 			// Legacy behavior, notify will be triggered on simulated proxies no different to the old system
 			UAnimMontage* Montage = Animation ? Cast<UAnimMontage>(Animation) : nullptr;
-			OnNotify(MeshComp, Montage);
+			OnNotify(MeshComp, Montage, UPlayMontageProStatics::MakeLegacyNotifyContext(MeshComp, Montage, EventReference));
 		}
 	}
 }
@@ -85,15 +131,50 @@ bool UAnimNotifyPro::ShouldTriggerNotify(USkeletalMeshComponent* MeshComp) const
 	return !MeshComp || MeshComp->GetNetMode() != NM_DedicatedServer || bTriggerOnDedicatedServer;
 }
 
-void UAnimNotifyPro::NotifyCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage)
+EAnimNotifyProNetFilter UAnimNotifyPro::GetNetFilter() const
 {
+	EAnimNotifyProNetFilter NetFilter = EAnimNotifyProNetFilter::None;
+	if (!bTriggerOnDedicatedServer)
+	{
+		NetFilter |= EAnimNotifyProNetFilter::DedicatedServer;
+	}
+
+	// Legacy notifies are already triggered on simulated proxies by Notify
+	if (SimulatedProxyBehavior == EAnimNotifyLegacyType::Legacy)
+	{
+		NetFilter |= EAnimNotifyProNetFilter::SimulatedProxy;
+	}
+	return NetFilter;
+}
+
+void UAnimNotifyPro::NotifyCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, const FAnimNotifyProContext& Context)
+{
+	// Nothing would handle the notify
+	const UAnimNotifyPro* Capabilities = GetClassCapabilities();
+	if (!Capabilities->bHasNativeOnNotify && !Capabilities->bHasBlueprintOnNotify)
+	{
+		return;
+	}
+
 	if (!MeshComp || MeshComp->GetNetMode() != NM_DedicatedServer || bTriggerOnDedicatedServer)
 	{
-		OnNotify(MeshComp, Montage);
+		OnNotify(MeshComp, Montage, Context);
 	}
 }
 
+void UAnimNotifyPro::OnNotify(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, const FAnimNotifyProContext& Context)
+{
+	// Forward to the old signature in case a subclass still overrides it
+PRAGMA_DISABLE_DEPRECATION_WARNINGS
+	OnNotify(MeshComp, Montage);
+PRAGMA_ENABLE_DEPRECATION_WARNINGS
+}
+
 void UAnimNotifyPro::OnNotify(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage)
 {
-	K2_OnNotify(MeshComp, Montage);
+	// Skip the ProcessEvent thunk when no Blueprint implements the event
+	if (GetClassCapabilities()->bHasBlueprintOnNotify)
+	{
+		K2_OnNotify(MeshComp, Montage);
+	}
 }
@@ -2,8 +2,10 @@
 
 
 #include "AnimNotifyStatePro.h"
+#include "PlayMontageProStatics.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Animation/AnimMontage.h"
+#include "UObject/UObjectIterator.h"
 
 #if WITH_EDITOR
 #include "Animation/DebugSkelMeshComponent.h"
@@ -14,33 +16,73 @@
 
 UAnimNotifyStatePro::UAnimNotifyStatePro(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, bHasNativeOnNotifyState(false)
+	, bHasBlueprintOnNotifyBegin(false)
+	, bHasBlueprintOnNotifyEnd(false)
+	, bHasBlueprintOnNotifyTick(false)
+	, bCapabilitiesCached(false)
 {
 #if WITH_EDITORONLY_DATA
 	// Pale yellow color
 	NotifyColor = FColor(255, 255, 200);
-	
-	auto ImplementedInBlueprint = [](const UFunction* Func) -> bool
+#endif
+}
+
+const UAnimNotifyStatePro* UAnimNotifyStatePro::GetClassCapabilities() const
+{
+	// Not looked up in the constructor, a Blueprint's default object is constructed before its functions are compiled
+	UAnimNotifyStatePro* ClassDefault = GetClass()->GetDefaultObject<UAnimNotifyStatePro>();
+	if (!ClassDefault->bCapabilitiesCached)
 	{
-		return Func && ensure(Func->GetOuter())
-			&& Func->GetOuter()->IsA(UBlueprintGeneratedClass::StaticClass());
-	};
+		ClassDefault->CacheClassCapabilities();
+	}
+	return ClassDefault;
+}
 
+void UAnimNotifyStatePro::InvalidateClassCapabilities()
+{
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		if (It->IsChildOf(StaticClass()))
+		{
+			if (UAnimNotifyStatePro* ClassDefault = Cast<UAnimNotifyStatePro>(It->GetDefaultObject(false)))
+			{
+				ClassDefault->bCapabilitiesCached = false;
+			}
+		}
+	}
+}
+
+void UAnimNotifyStatePro::CacheClassCapabilities()
+{
+	const UClass* Class = GetClass();
+
+	// Blueprints can't override OnNotifyBegin, OnNotifyEnd or OnNotifyTick, only a native class between this one and the class can
+	const UClass* NativeClass = Class;
+	while (NativeClass && !NativeClass->HasAnyClassFlags(CLASS_Native))
+	{
+		NativeClass = NativeClass->GetSuperClass();
+	}
+	bHasNativeOnNotifyState = NativeClass != UAnimNotifyStatePro::StaticClass();
+	bHasBlueprintOnNotifyBegin = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UAnimNotifyStatePro, K2_OnNotifyBegin));
+	bHasBlueprintOnNotifyEnd = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UAnimNotifyStatePro, K2_OnNotifyEnd));
+	bHasBlueprintOnNotifyTick = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UAnimNotifyStatePro, K2_OnNotifyTick));
+	bCapabilitiesCached = true;
+
+#if WITH_EDITORONLY_DATA
 	{
 		static FName FuncName = FName(TEXT("Received_NotifyBegin"));
-		const UFunction* BPFunc = GetClass()->FindFunctionByName(FuncName);
-		bHasBlueprintNotifyBegin = ImplementedInBlueprint(BPFunc);
+		bHasBlueprintNotifyBegin = Class->IsFunctionImplementedInScript(FuncName);
 	}
 
 	{
 		static FName FuncName = FName(TEXT("Received_NotifyTick"));
-		const UFunction* BPFunc = GetClass()->FindFunctionByName(FuncName);
-		bHasBlueprintNotifyTick = ImplementedInBlueprint(BPFunc);
+		bHasBlueprintNotifyTick = Class->IsFunctionImplementedInScript(FuncName);
 	}
 
 	{
 		static FName FuncName = FName(TEXT("Received_NotifyEnd"));
-		const UFunction* BPFunc = GetClass()->FindFunctionByName(FuncName);
-		bHasBlueprintNotifyEnd = ImplementedInBlueprint(BPFunc);
+		bHasBlueprintNotifyEnd = Class->IsFunctionImplementedInScript(FuncName);
 	}
 #endif
 }
@@ -50,7 +92,8 @@ UAnimNotifyStatePro::UAnimNotifyStatePro(const FObjectInitializer& ObjectInitial
 EDataValidationResult UAnimNotifyStatePro::IsDataValid(class FDataValidationContext& Context) const
 {
 #if WITH_EDITORONLY_DATA
-	if (bHasBlueprintNotifyBegin)
+	const UAnimNotifyStatePro* Capabilities = GetClassCapabilities();
+	if (Capabilities->bHasBlueprintNotifyBegin)
 	{
 		Context.AddError(
 			FText::Format(
@@ -62,19 +105,19 @@ EDataValidationResult UAnimNotifyStatePro::IsDataValid(class FDataValidationCont
 		);
 		return EDataValidationResult::Invalid;
 	}
-	if (bHasBlueprintNotifyTick)
+	if (Capabilities->bHasBlueprintNotifyTick)
 	{
 		Context.AddError(
 			FText::Format(
 				NSLOCTEXT("AnimNotifyStatePro", "BlueprintReceivedNotifyTickWarning",
 					"AnimNotifyPro {0} has a Blueprint implementation of Received_NotifyTick, which is not supported. "
-					"Ticking is not supported with Pro."),
+					"Please set TickInterval and use K2_OnNotifyTick instead."),
 				FText::FromString(GetName())
 			)
 		);
 		return EDataValidationResult::Invalid;
 	}
-	if (bHasBlueprintNotifyEnd)
+	if (Capabilities->bHasBlueprintNotifyEnd)
 	{
 		Context.AddError(
 			FText::Format(
@@ -90,6 +133,14 @@ EDataValidationResult UAnimNotifyStatePro::IsDataValid(class FDataValidationCont
 	return Super::IsDataValid(Context);
 }
 
+void UAnimNotifyStatePro::PostCDOCompiled(const FPostCDOCompiledContext& Context)
+{
+	Super::PostCDOCompiled(Context);
+
+	// The Blueprint's functions may have changed
+	bCapabilitiesCached = false;
+}
+
 #endif
 
 bool UAnimNotifyStatePro::WantsSimulatedProxyNotify(const USkeletalMeshComponent* MeshComp) const
@@ -114,7 +165,7 @@ void UAnimNotifyStatePro::NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSeq
 	if (MeshComp->IsA<UDebugSkelMeshComponent>() && ShouldFireInEditor())
 	{
 		UAnimMontage* Montage = Animation ? Cast<UAnimMontage>(Animation) : nullptr;
-		OnNotifyBegin(MeshComp, Montage, TotalDuration);
+		OnNotifyBegin(MeshComp, Montage, TotalDuration, UPlayMontageProStatics::MakeLegacyNotifyContext(MeshComp, Montage, EventReference));
 	}
 #endif
 
@@ -122,7 +173,33 @@ void UAnimNotifyStatePro::NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSeq
 	{
 		// Legacy behavior, notify will be triggered on simulated proxies no different to the old system
 		UAnimMontage* Montage = Animation ? Cast<UAnimMontage>(Animation) : nullptr;
-		OnNotifyBegin(MeshComp, Montage, TotalDuration);
+		OnNotifyBegin(MeshComp, Montage, TotalDuration, UPlayMontageProStatics::MakeLegacyNotifyContext(MeshComp, Montage, EventReference));
+	}
+}
+
+void UAnimNotifyStatePro::NotifyTick(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation,
+	float FrameDeltaTime, const FAnimNotifyEventReference& EventReference)
+{
+	// The engine ticks every frame, the legacy paths don't apply TickInterval beyond opting in
+	if (TickInterval == EAnimNotifyProTickInterval::None)
+	{
+		return;
+	}
+
+#if WITH_EDITOR
+	// Editor support -- for previewing in the editor
+	if (MeshComp->IsA<UDebugSkelMeshComponent>() && ShouldFireInEditor())
+	{
+		UAnimMontage* Montage = Animation ? Cast<UAnimMontage>(Animation) : nullptr;
+		OnNotifyTick(MeshComp, Montage, FrameDeltaTime);
+	}
+#endif
+
+	if (WantsSimulatedProxyNotify(MeshComp))
+	{
+		// Legacy behavior, notify will be triggered on simulated proxies no different to the old system
+		UAnimMontage* Montage = Animation ? Cast<UAnimMontage>(Animation) : nullptr;
+		OnNotifyTick(MeshComp, Montage, FrameDeltaTime);
 	}
 }
 
@@ -134,7 +211,7 @@ void UAnimNotifyStatePro::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSeque
 	if (MeshComp->IsA<UDebugSkelMeshComponent>() && ShouldFireInEditor())
 	{
 		UAnimMontage* Montage = Animation ? Cast<UAnimMontage>(Animation) : nullptr;
-		OnNotifyEnd(MeshComp, Montage);
+		OnNotifyEnd(MeshComp, Montage, UPlayMontageProStatics::MakeLegacyNotifyContext(MeshComp, Montage, EventReference, true));
 	}
 #endif
 
@@ -142,7 +219,7 @@ void UAnimNotifyStatePro::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSeque
 	{
 		// Legacy behavior, notify will be triggered on simulated proxies no different to the old system
 		UAnimMontage* Montage = Animation ? Cast<UAnimMontage>(Animation) : nullptr;
-		OnNotifyEnd(MeshComp, Montage);
+		OnNotifyEnd(MeshComp, Montage, UPlayMontageProStatics::MakeLegacyNotifyContext(MeshComp, Montage, EventReference, true));
 	}
 }
 
@@ -151,28 +228,107 @@ bool UAnimNotifyStatePro::ShouldTriggerNotify(USkeletalMeshComponent* MeshComp)
 	return !MeshComp || MeshComp->GetNetMode() != NM_DedicatedServer || bTriggerOnDedicatedServer;
 }
 
-void UAnimNotifyStatePro::NotifyBeginCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float TotalDuration)
+EAnimNotifyProNetFilter UAnimNotifyStatePro::GetNetFilter() const
+{
+	EAnimNotifyProNetFilter NetFilter = EAnimNotifyProNetFilter::None;
+	if (!bTriggerOnDedicatedServer)
+	{
+		NetFilter |= EAnimNotifyProNetFilter::DedicatedServer;
+	}
+
+	// Legacy notify states are already triggered on simulated proxies by NotifyBegin and NotifyEnd
+	if (SimulatedProxyBehavior == EAnimNotifyLegacyType::Legacy)
+	{
+		NetFilter |= EAnimNotifyProNetFilter::SimulatedProxy;
+	}
+	return NetFilter;
+}
+
+void UAnimNotifyStatePro::NotifyBeginCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float TotalDuration,
+	const FAnimNotifyProContext& Context)
 {
+	// Nothing would handle the notify
+	const UAnimNotifyStatePro* Capabilities = GetClassCapabilities();
+	if (!Capabilities->bHasNativeOnNotifyState && !Capabilities->bHasBlueprintOnNotifyBegin)
+	{
+		return;
+	}
+
+	if (ShouldTriggerNotify(MeshComp))
+	{
+		OnNotifyBegin(MeshComp, Montage, TotalDuration, Context);
+	}
+}
+
+void UAnimNotifyStatePro::NotifyEndCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, const FAnimNotifyProContext& Context)
+{
+	// Nothing would handle the notify
+	const UAnimNotifyStatePro* Capabilities = GetClassCapabilities();
+	if (!Capabilities->bHasNativeOnNotifyState && !Capabilities->bHasBlueprintOnNotifyEnd)
+	{
+		return;
+	}
+
 	if (ShouldTriggerNotify(MeshComp))
 	{
-		OnNotifyBegin(MeshComp, Montage, TotalDuration);
+		OnNotifyEnd(MeshComp, Montage, Context);
 	}
 }
 
-void UAnimNotifyStatePro::NotifyEndCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage)
+bool UAnimNotifyStatePro::WantsProTick() const
+{
+	const UAnimNotifyStatePro* Capabilities = GetClassCapabilities();
+	return TickInterval != EAnimNotifyProTickInterval::None && (Capabilities->bHasNativeOnNotifyState || Capabilities->bHasBlueprintOnNotifyTick);
+}
+
+void UAnimNotifyStatePro::NotifyTickCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float DeltaTime)
 {
 	if (ShouldTriggerNotify(MeshComp))
 	{
-		OnNotifyEnd(MeshComp, Montage);
+		OnNotifyTick(MeshComp, Montage, DeltaTime);
 	}
 }
 
+void UAnimNotifyStatePro::OnNotifyBegin(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float TotalDuration,
+	const FAnimNotifyProContext& Context)
+{
+	// Forward to the old signature in case a subclass still overrides it
+PRAGMA_DISABLE_DEPRECATION_WARNINGS
+	OnNotifyBegin(MeshComp, Montage, TotalDuration);
+PRAGMA_ENABLE_DEPRECATION_WARNINGS
+}
+
 void UAnimNotifyStatePro::OnNotifyBegin(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float TotalDuration)
 {
-	K2_OnNotifyBegin(MeshComp, Montage, TotalDuration);
+	// Skip the ProcessEvent thunk when no Blueprint implements the event
+	if (GetClassCapabilities()->bHasBlueprintOnNotifyBegin)
+	{
+		K2_OnNotifyBegin(MeshComp, Montage, TotalDuration);
+	}
+}
+
+void UAnimNotifyStatePro::OnNotifyEnd(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, const FAnimNotifyProContext& Context)
+{
+	// Forward to the old signature in case a subclass still overrides it
+PRAGMA_DISABLE_DEPRECATION_WARNINGS
+	OnNotifyEnd(MeshComp, Montage);
+PRAGMA_ENABLE_DEPRECATION_WARNINGS
 }
 
 void UAnimNotifyStatePro::OnNotifyEnd(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage)
 {
-	K2_OnNotifyEnd(MeshComp, Montage);
+	// Skip the ProcessEvent thunk when no Blueprint implements the event
+	if (GetClassCapabilities()->bHasBlueprintOnNotifyEnd)
+	{
+		K2_OnNotifyEnd(MeshComp, Montage);
+	}
+}
+
+void UAnimNotifyStatePro::OnNotifyTick(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float DeltaTime)
+{
+	// Skip the ProcessEvent thunk when no Blueprint implements the event
+	if (GetClassCapabilities()->bHasBlueprintOnNotifyTick)
+	{
+		K2_OnNotifyTick(MeshComp, Montage, DeltaTime);
+	}
 }
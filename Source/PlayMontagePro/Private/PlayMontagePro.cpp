@@ -1,18 +1,62 @@
 // Copyright (c) Jared Taylor
 
 #include "PlayMontagePro.h"
+#include "AnimNotifyPro.h"
+#include "AnimNotifyStatePro.h"
+
+DEFINE_LOG_CATEGORY(LogPlayMontagePro);
+
+DEFINE_STAT(STAT_PlayMontagePro_Gather);
+DEFINE_STAT(STAT_PlayMontagePro_Setup);
+DEFINE_STAT(STAT_PlayMontagePro_Dispatch);
+DEFINE_STAT(STAT_PlayMontagePro_ActiveTimelines);
+DEFINE_STAT(STAT_PlayMontagePro_TimersArmed);
+DEFINE_STAT(STAT_PlayMontagePro_EventsGathered);
+DEFINE_STAT(STAT_PlayMontagePro_EventsFired);
+DEFINE_STAT(STAT_PlayMontagePro_EventsEnsured);
+DEFINE_STAT(STAT_PlayMontagePro_EventsSkipped);
+DEFINE_STAT(STAT_PlayMontagePro_SectionChanges);
+DEFINE_STAT(STAT_PlayMontagePro_Retimes);
+
+CSV_DEFINE_CATEGORY_MODULE(PLAYMONTAGEPRO_API, PlayMontagePro, true);
 
 #define LOCTEXT_NAMESPACE "FPlayMontageProModule"
 
 void FPlayMontageProModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+
+	// Notify classes cache which hooks they implement, reinstanced or reloaded classes need to look them up again
+	FCoreUObjectDelegates::OnObjectsReplaced.AddRaw(this, &FPlayMontageProModule::OnObjectsReplaced);
+#if WITH_RELOAD
+	FCoreUObjectDelegates::ReloadCompleteDelegate.AddRaw(this, &FPlayMontageProModule::OnReloadComplete);
+#endif
 }
 
 void FPlayMontageProModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FCoreUObjectDelegates::OnObjectsReplaced.RemoveAll(this);
+#if WITH_RELOAD
+	FCoreUObjectDelegates::ReloadCompleteDelegate.RemoveAll(this);
+#endif
+}
+
+void FPlayMontageProModule::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap)
+{
+	InvalidateNotifyCapabilities();
+}
+
+void FPlayMontageProModule::OnReloadComplete(EReloadCompleteReason Reason)
+{
+	InvalidateNotifyCapabilities();
+}
+
+void FPlayMontageProModule::InvalidateNotifyCapabilities()
+{
+	UAnimNotifyPro::InvalidateClassCapabilities();
+	UAnimNotifyStatePro::InvalidateClassCapabilities();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -3,6 +3,7 @@
 #include "PlayMontageProCallbackProxy.h"
 
 #include "PlayMontageProStatics.h"
+#include "PlayMontageProSubsystem.h"
 #include "Animation/AnimMontage.h"
 #include "Components/SkeletalMeshComponent.h"
 
@@ -28,7 +29,8 @@ UPlayMontageProCallbackProxy* UPlayMontageProCallbackProxy::CreateProxyObjectFor
 	bool bEnableCustomTimeDilation,
 	bool bShouldStopAllMontages)
 {
-	UPlayMontageProCallbackProxy* Proxy = NewObject<UPlayMontageProCallbackProxy>();
+	// Proxies are pooled per world, reused once the montage they played has ended
+	UPlayMontageProCallbackProxy* Proxy = UPlayMontageProSubsystem::AcquireProxy(InSkeletalMeshComponent ? InSkeletalMeshComponent->GetWorld() : nullptr);
 	Proxy->SetFlags(RF_StrongRefOnFrame);
 	Proxy->PlayMontagePro(InSkeletalMeshComponent, MontageToPlay, PlayRate, StartingPosition, StartingSection,
 		bTriggerNotifiesBeforeStartTime, bEnableCustomTimeDilation, bShouldStopAllMontages);
@@ -74,37 +76,51 @@ bool UPlayMontageProCallbackProxy::PlayMontagePro(USkeletalMeshComponent* InSkel
 					StartingPosition += (NewPosition - StartingPosition);
 				}
 
-				BlendingOutDelegate.BindUObject(this, &ThisClass::OnMontageBlendingOut);
+				// Pooled proxies keep these bound from their last play
+				if (!BlendingOutDelegate.IsBound())
+				{
+					BlendingOutDelegate.BindUObject(this, &ThisClass::OnMontageBlendingOut);
+				}
 				AnimInstance->Montage_SetBlendingOutDelegate(BlendingOutDelegate, MontageToPlay);
 
-				MontageEndedDelegate.BindUObject(this, &ThisClass::OnMontageEnded);
+				if (!MontageEndedDelegate.IsBound())
+				{
+					MontageEndedDelegate.BindUObject(this, &ThisClass::OnMontageEnded);
+				}
 				AnimInstance->Montage_SetEndDelegate(MontageEndedDelegate, MontageToPlay);
 
 				// -- PlayMontagePro --
 				
-				// Use the mesh comp's OnTickPose to detect time dilation changes
-				if (bEnableCustomTimeDilation)
+				// Timelines are owned by the world's subsystem, we only keep a handle
+				// The timeline follows the owner's time dilation, changes are pushed by UPlayMontageProSubsystem::NotifyTimeDilationChanged
+				AActor* TimeDilationActor = bEnableCustomTimeDilation ? MeshComp->GetOwner() : nullptr;
+				if (FAnimNotifyProTimeline* Timeline = UPlayMontageProSubsystem::AcquireTimeline(MeshComp->GetWorld(), this, this, TimelineHandle, TimeDilationActor, MontageToPlay))
 				{
-					TimeDilation = MeshComp->GetOwner()->CustomTimeDilation;
-					TickPoseHandle = MeshComp->OnTickPose.AddUObject(this, &ThisClass::OnTickPose);
-				}
-				else
-				{
-					TimeDilation = 1.f;
-				}
+					// Notify times are in montage time, the timeline's clock runs at the play rate
+					Timeline->PlayRate = PlayRate;
+
+					// Polling the mesh comp's OnTickPose for time dilation set directly on the actor is opt-in
+					if (TimeDilationActor && UPlayMontageProStatics::ShouldPollTimeDilation())
+					{
+						TickPoseHandle = MeshComp->OnTickPose.AddUObject(this, &ThisClass::OnTickPose);
+					}
+
+					// Handle section changes
+					AnimInstance->OnMontageSectionChanged.AddDynamic(this, &ThisClass::OnMontageSectionChanged);
 
-				// Handle section changes
-				AnimInstance->OnMontageSectionChanged.AddDynamic(this, &ThisClass::OnMontageSectionChanged);
+					// Nothing is shared with other machines here, so notify trigger chances are rolled independently
+					Timeline->TriggerSeed = static_cast<uint32>(FMath::Rand());
 
-				// Gather notifies from montage
-				const FName Section = AnimInstance->Montage_GetCurrentSection(MontageToPlay);
-				UPlayMontageProStatics::GatherNotifies(this, MontageToPlay, NotifyId, Notifies, NotifyStatePairs, Section, StartingPosition, TimeDilation);
+					// Gather notifies from montage
+					const FName Section = AnimInstance->Montage_GetCurrentSection(MontageToPlay);
+					UPlayMontageProStatics::GatherNotifies(this, MontageToPlay, *Timeline, Section, StartingPosition);
 
-				// Trigger notifies before start time and remove them, if we want to trigger them before the start time
-				UPlayMontageProStatics::HandleHistoricNotifies(Notifies, NotifyStatePairs, bTriggerNotifiesBeforeStartTime, StartingPosition, this);
+					// Trigger notifies before start time and remove them, if we want to trigger them before the start time
+					UPlayMontageProStatics::HandleHistoricNotifies(*Timeline, bTriggerNotifiesBeforeStartTime, this);
 
-				// Create timer delegates for notifies
-				UPlayMontageProStatics::SetupNotifyTimers(this, MeshComp->GetWorld(), Notifies);
+					// Create timer delegates for notifies
+					UPlayMontageProStatics::SetupNotifyTimers(this, MeshComp->GetWorld(), *Timeline);
+				}
 			}
 		}
 	}
@@ -126,13 +142,13 @@ void UPlayMontageProCallbackProxy::OnMontageBlendingOut(UAnimMontage* InMontage,
 {
 	if (bInterrupted)
 	{
-		UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnInterrupted, Notifies, NotifyStatePairs, this);
+		UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnInterrupted, this);
 		OnInterrupted.Broadcast(NAME_None);
 		bInterruptedCalledBeforeBlendingOut = true;
 	}
 	else
 	{
-		UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::BlendOut, Notifies, NotifyStatePairs, this);
+		UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::BlendOut, this);
 		OnBlendOut.Broadcast(NAME_None);
 	}
 	bFinished = true;
@@ -142,17 +158,57 @@ void UPlayMontageProCallbackProxy::OnMontageEnded(UAnimMontage* InMontage, bool
 {
 	if (!bInterrupted)
 	{
-		UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnCompleted, Notifies, NotifyStatePairs, this);
+		UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnCompleted, this);
 		OnCompleted.Broadcast(NAME_None);
 	}
 	else if (!bInterruptedCalledBeforeBlendingOut)
 	{
-		UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnInterrupted, Notifies, NotifyStatePairs, this);
+		UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType::OnInterrupted, this);
 		OnInterrupted.Broadcast(NAME_None);
 	}
 	
-	UPlayMontageProStatics::ClearNotifyTimers(MeshComp->GetWorld(), Notifies);
+	UPlayMontageProSubsystem::ReleaseTimeline(TimelineHandle);
 	bFinished = true;
+
+	// The Blueprint has received its last event, the subsystem pools the proxy from the next frame if nothing still uses it
+	if (UPlayMontageProSubsystem* Subsystem = MeshComp.IsValid() ? UPlayMontageProSubsystem::Get(MeshComp->GetWorld()) : nullptr)
+	{
+		Subsystem->ReleaseProxy(this);
+	}
+}
+
+bool UPlayMontageProCallbackProxy::HasLiveListeners() const
+{
+	// Bindings whose object was destroyed can't be called, the node that bound them is gone with it
+	return OnCompleted.GetAllObjects().Num() > 0 || OnBlendOut.GetAllObjects().Num() > 0 || OnInterrupted.GetAllObjects().Num() > 0;
+}
+
+void UPlayMontageProCallbackProxy::ResetForPool()
+{
+	OnCompleted.Clear();
+	OnBlendOut.Clear();
+	OnInterrupted.Clear();
+
+	if (MeshComp.IsValid() && TickPoseHandle.IsValid())
+	{
+		MeshComp->OnTickPose.Remove(TickPoseHandle);
+	}
+	TickPoseHandle.Reset();
+
+	if (AnimInstancePtr.IsValid())
+	{
+		AnimInstancePtr->OnMontageSectionChanged.RemoveDynamic(this, &ThisClass::OnMontageSectionChanged);
+	}
+
+	// The blending out and ended delegates stay bound to this proxy, so the next play doesn't have to bind them again
+	UPlayMontageProSubsystem::ReleaseTimeline(TimelineHandle);
+
+	Montage.Reset();
+	MeshComp.Reset();
+	AnimInstancePtr.Reset();
+	MontageInstanceID = INDEX_NONE;
+	bInterruptedCalledBeforeBlendingOut = false;
+	bFinished = false;
 }
 
 void UPlayMontageProCallbackProxy::OnMontageSectionChanged(UAnimMontage* InMontage, FName SectionName, bool bLooped)
@@ -162,22 +218,23 @@ void UPlayMontageProCallbackProxy::OnMontageSectionChanged(UAnimMontage* InMonta
 		return;
 	}
 
-	const float StartTime = AnimInstancePtr->Montage_GetPosition(InMontage);
-
-	// End previous notify timers
-	UPlayMontageProStatics::ClearNotifyTimers(MeshComp->GetWorld(), Notifies);
-
-	// Gather notifies from montage
-	UPlayMontageProStatics::GatherNotifies(this, InMontage, NotifyId, Notifies, NotifyStatePairs, SectionName, StartTime, TimeDilation);
+	FAnimNotifyProTimeline* Timeline = GetTimeline();
+	if (!Timeline)
+	{
+		return;
+	}
 
-	// Create timer delegates for notifies
-	UPlayMontageProStatics::SetupNotifyTimers(this, MeshComp->GetWorld(), Notifies);
+	// Every section was gathered when the montage started, so we only move to the new position
+	UPlayMontageProStatics::HandleSectionChange(this, MeshComp->GetWorld(), *Timeline, AnimInstancePtr->Montage_GetPosition(InMontage), bLooped);
 }
 
 void UPlayMontageProCallbackProxy::OnTickPose(USkinnedMeshComponent* SkinnedMeshComponent, float DeltaTime,
 	bool NeedsValidRootMotion)
 {
-	UPlayMontageProStatics::HandleTimeDilation(this, SkinnedMeshComponent, TimeDilation, Notifies);
+	if (FAnimNotifyProTimeline* Timeline = GetTimeline())
+	{
+		UPlayMontageProStatics::HandleTimeDilation(this, SkinnedMeshComponent, *Timeline);
+	}
 }
 
 void UPlayMontageProCallbackProxy::BeginDestroy()
@@ -186,6 +243,8 @@ void UPlayMontageProCallbackProxy::BeginDestroy()
 	{
 		MeshComp->OnTickPose.Remove(TickPoseHandle);
 	}
+
+	UPlayMontageProSubsystem::ReleaseTimeline(TimelineHandle);
 	
 	Super::BeginDestroy();
 }
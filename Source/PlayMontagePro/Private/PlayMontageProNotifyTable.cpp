@@ -0,0 +1,50 @@
+// Copyright (c) Jared Taylor
+
+#include "PlayMontageProNotifyTable.h"
+
+#include "Animation/AnimMontage.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(PlayMontageProNotifyTable)
+
+bool UPlayMontageProNotifyTable::IsValidFor(const UAnimMontage* Montage) const
+{
+	return Montage && Version == LatestVersion && Schedule.Sections.Num() == Montage->CompositeSections.Num() &&
+		NotifyHash == HashNotifies(Montage);
+}
+
+namespace PlayMontagePro
+{
+	static uint32 HashClassPath(const UClass* Class)
+	{
+		return FCrc::StrCrc32(*Class->GetPathName());
+	}
+}
+
+uint32 UPlayMontageProNotifyTable::HashNotifies(const UAnimMontage* Montage)
+{
+	if (!Montage)
+	{
+		return 0;
+	}
+
+	uint32 Hash = GetTypeHash(Montage->CompositeSections.Num());
+	for (const FCompositeSection& Section : Montage->CompositeSections)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(Section.GetTime()));
+	}
+
+	// Class paths as text, FName hashes are name table slots that differ between the cooker and the cooked build
+	Hash = HashCombine(Hash, GetTypeHash(Montage->Notifies.Num()));
+	for (const FAnimNotifyEvent& Notify : Montage->Notifies)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(Notify.GetTime()));
+		Hash = HashCombine(Hash, GetTypeHash(Notify.GetDuration()));
+		Hash = HashCombine(Hash, GetTypeHash(Notify.NotifyTriggerChance));
+		Hash = HashCombine(Hash, GetTypeHash(static_cast<uint8>(Notify.NotifyFilterType)));
+		Hash = HashCombine(Hash, GetTypeHash(Notify.NotifyFilterLOD));
+		Hash = HashCombine(Hash, GetTypeHash(Notify.bTriggerOnDedicatedServer));
+		Hash = HashCombine(Hash, Notify.Notify ? PlayMontagePro::HashClassPath(Notify.Notify->GetClass()) : 0);
+		Hash = HashCombine(Hash, Notify.NotifyStateClass ? PlayMontagePro::HashClassPath(Notify.NotifyStateClass->GetClass()) : 0);
+	}
+	return Hash;
+}
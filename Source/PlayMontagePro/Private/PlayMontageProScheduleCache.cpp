@@ -0,0 +1,199 @@
+// Copyright (c) Jared Taylor
+
+#include "PlayMontageProScheduleCache.h"
+
+#include "PlayMontagePro.h"
+#include "PlayMontageProNotifyTable.h"
+#include "PlayMontageProStatics.h"
+#include "PlayMontageProTrace.h"
+#include "Animation/AnimMontage.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_EDITOR
+#include "Misc/TransactionObjectEvent.h"
+#endif
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(PlayMontageProScheduleCache)
+
+static FAutoConsoleCommand CVarPlayMontageProScheduleCacheDump(
+	TEXT("PlayMontagePro.ScheduleCache.Dump"),
+	TEXT("Logs the number of cached Pro notify schedules and the cache hit rate"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		if (const UPlayMontageProScheduleCache* Cache = UPlayMontageProScheduleCache::Get())
+		{
+			UE_LOG(LogPlayMontagePro, Log, TEXT("ScheduleCache: %d schedules, %lld hits, %lld misses (%lld from baked tables), %.1f%% hit rate"),
+				Cache->GetNumCachedSchedules(), Cache->GetCacheHits(), Cache->GetCacheMisses(), Cache->GetBakedTableLoads(),
+				Cache->GetCacheHitRate() * 100.f);
+		}
+	}));
+
+static FAutoConsoleCommand CVarPlayMontageProScheduleCacheFlush(
+	TEXT("PlayMontagePro.ScheduleCache.Flush"),
+	TEXT("Discards every cached Pro notify schedule and resets the hit rate"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		if (UPlayMontageProScheduleCache* Cache = UPlayMontageProScheduleCache::Get())
+		{
+			Cache->InvalidateAllSchedules();
+			Cache->ResetCacheStats();
+		}
+	}));
+
+UPlayMontageProScheduleCache* UPlayMontageProScheduleCache::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UPlayMontageProScheduleCache>() : nullptr;
+}
+
+TSharedRef<const FAnimNotifyProSchedule> UPlayMontageProScheduleCache::FindOrBuildSchedule(const UAnimMontage* Montage)
+{
+	if (UPlayMontageProScheduleCache* Cache = Get())
+	{
+		return Cache->GetSchedule(Montage);
+	}
+
+	TSharedRef<FAnimNotifyProSchedule> Schedule = MakeShared<FAnimNotifyProSchedule>();
+	UPlayMontageProStatics::BuildNotifySchedule(Montage, *Schedule);
+	return Schedule;
+}
+
+void UPlayMontageProScheduleCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &ThisClass::OnPostGarbageCollect);
+
+#if WITH_EDITOR
+	ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &ThisClass::OnObjectPropertyChanged);
+	ObjectTransactedHandle = FCoreUObjectDelegates::OnObjectTransacted.AddUObject(this, &ThisClass::OnObjectTransacted);
+	ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddUObject(this, &ThisClass::OnObjectsReplaced);
+#endif
+}
+
+void UPlayMontageProScheduleCache::Deinitialize()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+	FCoreUObjectDelegates::OnObjectTransacted.Remove(ObjectTransactedHandle);
+	FCoreUObjectDelegates::OnObjectsReplaced.Remove(ObjectsReplacedHandle);
+#endif
+
+	Schedules.Empty();
+
+	Super::Deinitialize();
+}
+
+TSharedRef<const FAnimNotifyProSchedule> UPlayMontageProScheduleCache::GetSchedule(const UAnimMontage* Montage)
+{
+	if (const TSharedRef<const FAnimNotifyProSchedule>* Schedule = Schedules.Find(Montage))
+	{
+		++CacheHits;
+		return *Schedule;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProScheduleCache::BuildSchedule);
+
+	++CacheMisses;
+	TSharedRef<FAnimNotifyProSchedule> Schedule = MakeShared<FAnimNotifyProSchedule>();
+	bool bBaked = false;
+
+#if !WITH_EDITOR
+	// Cooked montages carry a table baked by the editor module, the editor always rebuilds because unsaved edits make it stale
+	const UPlayMontageProNotifyTable* Table = Montage ? const_cast<UAnimMontage*>(Montage)->GetAssetUserData<UPlayMontageProNotifyTable>() : nullptr;
+	if (Table && Table->IsValidFor(Montage))
+	{
+		++BakedTableLoads;
+		*Schedule = Table->Schedule;
+		bBaked = true;
+	}
+	else
+#endif
+	{
+		UPlayMontageProStatics::BuildNotifySchedule(Montage, *Schedule);
+	}
+
+	TRACE_PLAYMONTAGEPRO_SCHEDULE_BUILT(Montage, *Schedule, bBaked);
+
+	Schedules.Add(Montage, Schedule);
+	return Schedule;
+}
+
+void UPlayMontageProScheduleCache::InvalidateSchedule(const UAnimMontage* Montage)
+{
+	Schedules.Remove(Montage);
+}
+
+void UPlayMontageProScheduleCache::InvalidateAllSchedules()
+{
+	Schedules.Reset();
+}
+
+float UPlayMontageProScheduleCache::GetCacheHitRate() const
+{
+	const int64 Requests = CacheHits + CacheMisses;
+	return Requests > 0 ? static_cast<float>(static_cast<double>(CacheHits) / static_cast<double>(Requests)) : 0.f;
+}
+
+void UPlayMontageProScheduleCache::ResetCacheStats()
+{
+	CacheHits = 0;
+	CacheMisses = 0;
+	BakedTableLoads = 0;
+}
+
+void UPlayMontageProScheduleCache::OnPostGarbageCollect()
+{
+	// Purge schedules for montages that no longer exist, their notify pointers are no longer valid
+	for (auto It = Schedules.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+#if WITH_EDITOR
+
+namespace PlayMontagePro
+{
+	/** @return The montage itself, or the montage that a notify is instanced within */
+	static const UAnimMontage* GetOwningMontage(const UObject* Object)
+	{
+		if (const UAnimMontage* Montage = Cast<UAnimMontage>(Object))
+		{
+			return Montage;
+		}
+		return Object ? Object->GetTypedOuter<UAnimMontage>() : nullptr;
+	}
+}
+
+void UPlayMontageProScheduleCache::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// Editing the montage or any notify instanced within it can change the schedule
+	if (const UAnimMontage* Montage = PlayMontagePro::GetOwningMontage(Object))
+	{
+		InvalidateSchedule(Montage);
+	}
+}
+
+void UPlayMontageProScheduleCache::OnObjectTransacted(UObject* Object, const FTransactionObjectEvent& TransactionEvent)
+{
+	// Undo and redo restore montage state without calling PostEditChangeProperty
+	if (const UAnimMontage* Montage = PlayMontagePro::GetOwningMontage(Object))
+	{
+		InvalidateSchedule(Montage);
+	}
+}
+
+void UPlayMontageProScheduleCache::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap)
+{
+	// Blueprint recompiles and reinstancing replace the notify objects the schedules point to
+	InvalidateAllSchedules();
+}
+
+#endif
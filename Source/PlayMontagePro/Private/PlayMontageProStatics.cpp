@@ -5,14 +5,417 @@
 
 #include "AnimNotifyPro.h"
 #include "AnimNotifyStatePro.h"
+#include "PlayMontagePro.h"
 #include "PlayMontageProInterface.h"
+#include "PlayMontageProScheduleCache.h"
+#include "PlayMontageProSubsystem.h"
+#include "PlayMontageProTrace.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/StableSort.h"
+#include "Animation/AnimInstance.h"
 #include "Animation/AnimMontage.h"
+#include "Animation/AnimNotifyQueue.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
 #include "TimerManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(PlayMontageProStatics)
 
+static int32 GPlayMontageProScheduleMode = 0;
+static FAutoConsoleVariableRef CVarPlayMontageProScheduleMode(TEXT("PlayMontagePro.ScheduleMode"), GPlayMontageProScheduleMode, TEXT("How Pro notifies are woken up. 0: One timer per notify. 1: A single timer per montage, armed for its next due notify. 2: No timers, the world's UPlayMontageProSubsystem ticks every montage's next due notify. Retiming a montage re-arms every pending timer in mode 0, only one in mode 1 and none in mode 2. Applies to montages played after it is changed"));
+
+static bool GPlayMontageProPollTimeDilation = false;
+static FAutoConsoleVariableRef CVarPlayMontageProPollTimeDilation(TEXT("PlayMontagePro.PollTimeDilation"), GPlayMontageProPollTimeDilation, TEXT("If true, PlayMontage nodes with custom time dilation enabled poll it every time the mesh ticks pose, for games that set CustomTimeDilation directly instead of using SetActorCustomTimeDilation. Applies to montages played after it is changed"));
+
+static float GPlayMontageProSignificanceThreshold = 0.5f;
+static FAutoConsoleVariableRef CVarPlayMontageProSignificanceThreshold(TEXT("PlayMontagePro.Significance.Threshold"), GPlayMontageProSignificanceThreshold, TEXT("Meshes whose significance is below this when a montage starts skip its non-critical Pro notifies, unless they have EnsureTriggerNotify set. Significance is in the range 0 to 1, see UPlayMontageProStatics::SignificanceDelegate"));
+
+static bool GPlayMontageProSignificanceUseVisibility = false;
+static FAutoConsoleVariableRef CVarPlayMontageProSignificanceUseVisibility(TEXT("PlayMontagePro.Significance.UseVisibility"), GPlayMontageProSignificanceUseVisibility, TEXT("If true and no SignificanceDelegate is bound, meshes that weren't recently rendered are not significant. Ignored on dedicated servers"));
+
+static float GPlayMontageProSeekTolerance = 0.1f;
+static FAutoConsoleVariableRef CVarPlayMontageProSeekTolerance(TEXT("PlayMontagePro.SeekTolerance"), GPlayMontageProSeekTolerance, TEXT("How far ahead of its Pro notify clock, in montage seconds, a montage has to be when a notify is due before it is treated as a seek, e.g. from a direct call to Montage_SetPosition"));
+
+namespace PlayMontagePro
+{
+	/** @return True if the event has neither been broadcast, skipped, filtered out nor deferred */
+	static bool IsPendingNotify(const FAnimNotifyProEvent& Event)
+	{
+		return !Event.bHasBroadcast && !Event.bNotifySkipped && !Event.bFiltered && !Event.bDeferred;
+	}
+
+	/** Broadcasts a due event, or defers it to a later frame if the subsystem's dispatch budget for this frame is spent */
+	static void BroadcastWithinBudget(UPlayMontageProSubsystem* BudgetSubsystem, FAnimNotifyProTimeline& Timeline, int32 Index,
+		IPlayMontageProInterface* Interface)
+	{
+		if (!BudgetSubsystem)
+		{
+			UPlayMontageProStatics::BroadcastNotifyEvent(Timeline, Timeline.Notifies[Index], Interface);
+			return;
+		}
+
+		if (BudgetSubsystem->TryDeferNotify(Timeline, Index))
+		{
+			return;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		UPlayMontageProStatics::BroadcastNotifyEvent(Timeline, Timeline.Notifies[Index], Interface);
+		BudgetSubsystem->AddDispatchTime(FPlatformTime::Seconds() - StartTime);
+	}
+
+	/** @return The net contexts the mesh plays montages in, events whose entry filters any of them are dropped when gathered */
+	static EAnimNotifyProNetFilter GetNetContext(const USkeletalMeshComponent* MeshComp)
+	{
+		EAnimNotifyProNetFilter NetContext = EAnimNotifyProNetFilter::None;
+		if (!MeshComp)
+		{
+			return NetContext;
+		}
+
+		if (MeshComp->GetNetMode() == NM_DedicatedServer)
+		{
+			NetContext |= EAnimNotifyProNetFilter::DedicatedServer;
+		}
+
+		const AActor* Owner = MeshComp->GetOwner();
+		if (IsValid(Owner) && Owner->GetNetMode() != NM_Standalone && Owner->GetLocalRole() == ROLE_SimulatedProxy)
+		{
+			NetContext |= EAnimNotifyProNetFilter::SimulatedProxy;
+		}
+		return NetContext;
+	}
+
+	/** @return Whether the entry passes its LOD filter and trigger chance, the chance is rolled from the timeline's seed so a seed always gives the same result */
+	static bool PassesTriggerFilters(const FAnimNotifyProTimeline& Timeline, const FAnimNotifyProScheduleEntry& Entry, int32 PredictedLOD)
+	{
+		if (Entry.FilterLOD != INDEX_NONE && PredictedLOD >= Entry.FilterLOD)
+		{
+			return false;
+		}
+
+		// Begin and end states share their notify index, so both roll the same
+		if (Entry.TriggerChance < 1.f)
+		{
+			const uint32 Seed = HashCombineFast(Timeline.TriggerSeed, GetTypeHash(Entry.NotifyIndex));
+			return FRandomStream(static_cast<int32>(Seed)).FRand() < Entry.TriggerChance;
+		}
+		return true;
+	}
+
+	/** @return Whether the entry is filtered out when the mesh isn't significant */
+	static bool IsSignificanceFiltered(const FAnimNotifyProScheduleEntry& Entry)
+	{
+		return !Entry.bCritical && Entry.EnsureTriggerNotify == 0;
+	}
+
+	/** @return Delay until the clock reaches the montage position, or a negative value if the clock is stopped */
+	static float GetClockDelay(const FAnimNotifyProTimeline& Timeline, float ClockTime, double WorldTime)
+	{
+		// A rate of zero would clear the timer instead of firing it, so anything already due fires next tick
+		const double DueTime = Timeline.GetWorldTimeAt(ClockTime);
+		return DueTime < 0.0 ? -1.f : FMath::Max(static_cast<float>(DueTime - WorldTime), UE_KINDA_SMALL_NUMBER);
+	}
+
+	/** @return Delay until the event is due on the timeline's clock, or a negative value if the clock is stopped */
+	static float GetNotifyDelay(const FAnimNotifyProTimeline& Timeline, const FAnimNotifyProEvent& Event, double WorldTime)
+	{
+		return GetClockDelay(Timeline, Event.Time, WorldTime);
+	}
+
+	/** @return The custom time dilation of the actor the timeline follows, or its current time dilation if it doesn't follow one */
+	static float GetFollowedTimeDilation(const FAnimNotifyProTimeline& Timeline)
+	{
+		const AActor* Actor = Timeline.TimeDilationActor.ResolveObjectPtr();
+		return Actor ? Actor->CustomTimeDilation : Timeline.TimeDilation;
+	}
+
+	/** Calls the function for every timeline whose PlayMontage node is playing the montage, or any montage if nullptr, on the anim instance */
+	static void ForEachMontageTimeline(const UAnimInstance* AnimInstance, const UAnimMontage* Montage,
+		TFunctionRef<void(FAnimNotifyProTimeline&)> Function)
+	{
+		UPlayMontageProSubsystem* Subsystem = UPlayMontageProSubsystem::Get(AnimInstance->GetWorld());
+		if (!Subsystem)
+		{
+			return;
+		}
+
+		// Only the mesh's own timelines are visited, so retiming many actors doesn't scan the whole pool for each
+		Subsystem->ForEachMeshTimeline(AnimInstance->GetSkelMeshComponent(), [Montage, &Function](FAnimNotifyProTimeline& Timeline)
+		{
+			const IPlayMontageProInterface* Interface = Timeline.GetInterface();
+			if (Interface && (!Montage || Interface->GetMontage() == Montage))
+			{
+				Function(Timeline);
+			}
+		});
+	}
+
+	/** Removes the event from every pending ensure bitset, once it has fired or can no longer fire */
+	static void ClearPendingEnsure(FAnimNotifyProTimeline& Timeline, int32 Index)
+	{
+		for (TBitArray<>& Pending : Timeline.PendingEnsure)
+		{
+			Pending[Index] = false;
+		}
+		Timeline.PendingEndStates[Index] = false;
+	}
+
+	/** @return The events in the current section */
+	static TConstArrayView<FAnimNotifyProEvent> GetSectionEvents(const FAnimNotifyProTimeline& Timeline)
+	{
+		return MakeArrayView(Timeline.Notifies.GetData() + Timeline.SectionBegin, Timeline.SectionEnd - Timeline.SectionBegin);
+	}
+
+	/** Arms or re-arms a notify timer, counting it in the subsystem's live count of armed timers if it wasn't already */
+	static void SetNotifyTimer(const UWorld* World, UPlayMontageProSubsystem* Subsystem, FTimerHandle& Handle, const FTimerDelegate& Delegate, float Delay)
+	{
+		FTimerManager& TimerManager = World->GetTimerManager();
+		const bool bWasArmed = TimerManager.TimerExists(Handle);
+		TimerManager.SetTimer(Handle, Delegate, Delay, false);
+		if (!bWasArmed && Subsystem)
+		{
+			Subsystem->AddArmedTimers(1);
+		}
+	}
+
+	/** Clears a notify timer, removing it from the subsystem's live count of armed timers if it was still armed */
+	static void ClearNotifyTimer(const UWorld* World, FTimerHandle& Handle)
+	{
+		FTimerManager& TimerManager = World->GetTimerManager();
+		if (TimerManager.TimerExists(Handle))
+		{
+			if (UPlayMontageProSubsystem* Subsystem = UPlayMontageProSubsystem::Get(World))
+			{
+				Subsystem->AddArmedTimers(-1);
+			}
+		}
+		TimerManager.ClearTimer(Handle);
+	}
+
+	/** Arms the legacy per-event timer, its delegate resolves the event through a generation checked handle */
+	static void ArmNotifyTimer(const UWorld* World, FAnimNotifyProTimeline& Timeline, int32 Index, float Delay)
+	{
+		// Built when armed rather than stored per event, the timer manager keeps its own copy either way
+		if (UPlayMontageProSubsystem* Subsystem = UPlayMontageProSubsystem::Get(World))
+		{
+			FAnimNotifyProEvent& Event = Timeline.Notifies[Index];
+			SetNotifyTimer(World, Subsystem, Event.Timer, Subsystem->CreateNotifyTimerDelegate(Timeline, Index), Delay);
+			if (!Event.bArmed)
+			{
+				Event.bArmed = true;
+				TRACE_PLAYMONTAGEPRO_NOTIFY(Armed, Timeline, Index, Timeline.ScheduleMode);
+			}
+		}
+	}
+
+	/** Re-arms the per-event timer of every pending event in the section from the clock, after its rate or reading changed */
+	static void RearmNotifyTimers(const UWorld* World, FAnimNotifyProTimeline& Timeline)
+	{
+		const double WorldTime = World->GetTimeSeconds();
+		for (int32 Index = Timeline.SectionBegin; Index < Timeline.SectionEnd; Index++)
+		{
+			FAnimNotifyProEvent& Notify = Timeline.Notifies[Index];
+			if (!IsPendingNotify(Notify))
+			{
+				continue;
+			}
+
+			const float Delay = GetNotifyDelay(Timeline, Notify, WorldTime);
+			if (Delay > 0.f)
+			{
+				ArmNotifyTimer(World, Timeline, Index, Delay);
+			}
+			else
+			{
+				ClearNotifyTimer(World, Notify.Timer);
+			}
+		}
+	}
+
+	/** @return Index of the first event in the current section at or after the montage position, or SectionEnd if there is none */
+	static int32 FindFirstEventAt(const FAnimNotifyProTimeline& Timeline, float Position)
+	{
+		return Timeline.SectionBegin + Algo::LowerBoundBy(GetSectionEvents(Timeline), Position - UE_KINDA_SMALL_NUMBER, &FAnimNotifyProEvent::Time);
+	}
+
+	/** @return Index of the first event in the current section after the montage position, or SectionEnd if there is none */
+	static int32 FindFirstEventAfter(const FAnimNotifyProTimeline& Timeline, float Position)
+	{
+		return Timeline.SectionBegin + Algo::UpperBoundBy(GetSectionEvents(Timeline), Position + UE_KINDA_SMALL_NUMBER, &FAnimNotifyProEvent::Time);
+	}
+
+	/** Makes the event pending again, so it fires and is ensured as if it had never been reached */
+	static void ResetPendingNotify(FAnimNotifyProTimeline& Timeline, int32 Index)
+	{
+		FAnimNotifyProEvent& Event = Timeline.Notifies[Index];
+		Event.bHasBroadcast = false;
+		Event.bNotifySkipped = false;
+		Event.bArmed = false;
+
+		// Its entry in the deferred queue no longer resolves
+		Event.bDeferred = false;
+
+		// Filtered events stay out of the ensure bitsets, EnterSection has already cleared them
+		if (Event.bFiltered)
+		{
+			return;
+		}
+
+		// Begin states sort before their end state, so the begin state has already been reset if it is also being replayed
+		const FAnimNotifyProScheduleEntry& Entry = Timeline.GetEntry(Index);
+		const FAnimNotifyProEvent* BeginState = Event.bIsEndState && Timeline.Notifies.IsValidIndex(Entry.PairIndex) ? &Timeline.Notifies[Entry.PairIndex] : nullptr;
+		if (BeginState && BeginState->bNotifySkipped)
+		{
+			Event.bNotifySkipped = true;
+			return;
+		}
+
+		for (int32 Flag = 0; Flag < FAnimNotifyProTimeline::NumEnsureEventTypes; Flag++)
+		{
+			Timeline.PendingEnsure[Flag][Index] = (Entry.EnsureTriggerNotify & (1 << Flag)) != 0;
+		}
+		Timeline.PendingEndStates[Index] = BeginState && BeginState->bHasBroadcast;
+	}
+
+	/** Moves the clock into the section, every event in it becomes pending and events in other sections can no longer fire */
+	static void EnterSection(FAnimNotifyProTimeline& Timeline, const UAnimMontage* Montage, int32 SectionIndex, float Position)
+	{
+		for (TBitArray<>& Pending : Timeline.PendingEnsure)
+		{
+			Pending.SetRange(0, Pending.Num(), false);
+		}
+		Timeline.PendingEndStates.SetRange(0, Timeline.PendingEndStates.Num(), false);
+
+		const bool bValidSection = Timeline.Schedule.IsValid() && Timeline.Schedule->Sections.IsValidIndex(SectionIndex);
+		Timeline.SectionIndex = bValidSection ? SectionIndex : INDEX_NONE;
+		Timeline.SectionBegin = bValidSection ? Timeline.Schedule->Sections[SectionIndex].FirstEntry : 0;
+		Timeline.SectionEnd = bValidSection ? Timeline.SectionBegin + Timeline.Schedule->Sections[SectionIndex].NumEntries : 0;
+		for (int32 Index = Timeline.SectionBegin; Index < Timeline.SectionEnd; Index++)
+		{
+			ResetPendingNotify(Timeline, Index);
+		}
+
+		float SectionStartTime = 0.f;
+		Timeline.SectionEndTime = 0.f;
+		if (bValidSection)
+		{
+			Montage->GetSectionStartAndEndTime(SectionIndex, SectionStartTime, Timeline.SectionEndTime);
+		}
+
+		// The clock starts from the position once the timers are set up
+		Timeline.ClockBase = Position;
+		Timeline.Cursor = Timeline.SectionBegin;
+	}
+
+	/**
+	 * Moves the clock into the montage's next section once it reaches the end of the current one, carrying over the time spent past it.
+	 * Lets cursor and tick scheduling dispatch the start of the next section or loop without waiting for OnMontageSectionChanged.
+	 * @return True if the clock moved into the next section.
+	 */
+	static bool FollowNextSection(IPlayMontageProInterface* Interface, FAnimNotifyProTimeline& Timeline, double WorldTime)
+	{
+		const float ClockTime = Timeline.GetClockTime(WorldTime);
+		if (Timeline.SectionIndex == INDEX_NONE || ClockTime < Timeline.SectionEndTime - UE_KINDA_SMALL_NUMBER)
+		{
+			return false;
+		}
+
+		const UAnimMontage* Montage = Interface->GetMontage();
+		const FAnimMontageInstance* MontageInstance = UPlayMontageProStatics::GetMontageInstance(Interface);
+		const int32 NextSectionIndex = MontageInstance ? MontageInstance->GetNextSectionID(Timeline.SectionIndex) : INDEX_NONE;
+		if (!Montage || NextSectionIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		float NextSectionStartTime = 0.f;
+		float NextSectionEndTime = 0.f;
+		Montage->GetSectionStartAndEndTime(NextSectionIndex, NextSectionStartTime, NextSectionEndTime);
+
+		// Entering a section only resets the flags of its events, so looping doesn't gather or allocate anything
+		const float Overflow = ClockTime - Timeline.SectionEndTime;
+		EnterSection(Timeline, Montage, NextSectionIndex, NextSectionStartTime + Overflow);
+		Timeline.ClockWorldTime = WorldTime;
+		Timeline.bAwaitingSectionChange = true;
+		return true;
+	}
+
+	/** @return Index of the first set bit at or after StartIndex, or INDEX_NONE */
+	static int32 FindNextSetBit(const TBitArray<>& Bits, int32 StartIndex)
+	{
+		if (StartIndex >= Bits.Num())
+		{
+			return INDEX_NONE;
+		}
+		const TConstSetBitIterator<> It(Bits, StartIndex);
+		return It ? It.GetIndex() : INDEX_NONE;
+	}
+
+	/** @return Index of the first event at or after StartIndex that still needs ensuring for the event type, or INDEX_NONE */
+	static int32 FindNextPendingEnsure(const FAnimNotifyProTimeline& Timeline, EAnimNotifyProEventType EventType,
+		bool bEnsureEndStates, int32 StartIndex)
+	{
+		int32 NextIndex = bEnsureEndStates ? FindNextSetBit(Timeline.PendingEndStates, StartIndex) : INDEX_NONE;
+		for (int32 Flag = 0; Flag < FAnimNotifyProTimeline::NumEnsureEventTypes; Flag++)
+		{
+			if (EnumHasAnyFlags(EventType, static_cast<EAnimNotifyProEventType>(1 << Flag)))
+			{
+				const int32 Index = FindNextSetBit(Timeline.PendingEnsure[Flag], StartIndex);
+				if (Index != INDEX_NONE && (NextIndex == INDEX_NONE || Index < NextIndex))
+				{
+					NextIndex = Index;
+				}
+			}
+		}
+		return NextIndex;
+	}
+
+	/**
+	 * Picks up Montage_SetPlayRate, Montage_SetPosition and CustomTimeDilation changes that bypassed our statics, called when a notify is due.
+	 * Section changes are left to OnMontageSectionChanged.
+	 * @return True if the montage was ahead of the clock and the timeline was seeked to it, which sets up its timers again.
+	 */
+	static bool SyncWithMontageInstance(IPlayMontageProInterface* Interface, const UWorld* World, FAnimNotifyProTimeline& Timeline)
+	{
+		const FAnimMontageInstance* MontageInstance = UPlayMontageProStatics::GetMontageInstance(Interface);
+		if (!MontageInstance)
+		{
+			return false;
+		}
+
+		UPlayMontageProStatics::SetTimelineRate(World, Timeline, MontageInstance->GetPlayRate(), GetFollowedTimeDilation(Timeline));
+
+		const float Position = MontageInstance->GetPosition();
+		const float ClockTime = Timeline.GetClockTime(World->GetTimeSeconds());
+		const UAnimMontage* Montage = Interface->GetMontage();
+		if (!Montage || Timeline.bAwaitingSectionChange || Montage->GetSectionIndexFromPosition(Position) != Timeline.SectionIndex)
+		{
+			return false;
+		}
+
+		if (Position > ClockTime + GPlayMontageProSeekTolerance)
+		{
+			UPlayMontageProStatics::SeekTimeline(Interface, World, Timeline, Position);
+			return true;
+		}
+
+		if (Position < ClockTime - GPlayMontageProSeekTolerance)
+		{
+			// Behind the clock, e.g. paused with Montage_Pause, wait for the montage without replaying what already fired
+			Timeline.ClockBase = Position;
+			Timeline.ClockWorldTime = World->GetTimeSeconds();
+			if (!Timeline.UsesCursor())
+			{
+				RearmNotifyTimers(World, Timeline);
+			}
+		}
+		return false;
+	}
+}
+
 float UPlayMontageProStatics::GetMontagePlayRateScaledByDuration(const UAnimMontage* Montage, float Duration)
 {
 	if (Montage && Duration > 0.f)
@@ -22,182 +425,540 @@ float UPlayMontageProStatics::GetMontagePlayRateScaledByDuration(const UAnimMont
 	return 1.f;
 }
 
-void UPlayMontageProStatics::GatherNotifies(const UObject* TaskOwner, UAnimMontage* Montage, uint32& NotifyId,
-	TArray<FAnimNotifyProEvent>& Notifies, TMap<uint32, uint32>& NotifyStatePairs,
-	const FName& Section, float StartPosition, float TimeDilation)
+void UPlayMontageProStatics::BuildNotifySchedule(const UAnimMontage* Montage, FAnimNotifyProSchedule& OutSchedule)
 {
-	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::GatherNotifies);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::BuildNotifySchedule);
 
-	const int32 SectionIndex = Montage->GetSectionIndex(Section);
+	OutSchedule.Entries.Reset();
+	OutSchedule.Sections.Reset();
+	OutSchedule.NetFilters = EAnimNotifyProNetFilter::None;
+	OutSchedule.bHasTriggerFilters = false;
+	OutSchedule.bHasSignificanceFilters = false;
 
-	Notifies.Reset();
-	NotifyStatePairs.Reset();
-	TArray<FAnimNotifyEvent>& MontageNotifies = Montage->Notifies;
-	for (FAnimNotifyEvent& MontageNotify : MontageNotifies)
+	if (!Montage)
 	{
+		return;
+	}
+
+	// Bucket entries by the section they trigger in, paired indices are local to the bucket until flattened
+	const int32 NumSections = Montage->CompositeSections.Num();
+	TArray<TArray<FAnimNotifyProScheduleEntry>> Buckets;
+	Buckets.SetNum(NumSections);
+
+	const TArray<FAnimNotifyEvent>& MontageNotifies = Montage->Notifies;
+	for (int32 NotifyIndex = 0; NotifyIndex < MontageNotifies.Num(); NotifyIndex++)
+	{
+		const FAnimNotifyEvent& MontageNotify = MontageNotifies[NotifyIndex];
 		const float NotifyTime = MontageNotify.GetTime();
-		const float NotifyDuration = MontageNotify.GetDuration() * TimeDilation;
-		const float StartTime = (NotifyTime - StartPosition) * TimeDilation;
 
-		// Add notify to the list of notifies
-		if (UAnimNotifyPro* Notify = MontageNotify.Notify ? Cast<UAnimNotifyPro>(MontageNotify.Notify) : nullptr)
+		// Trigger settings are evaluated per play when gathered
+		const float TriggerChance = MontageNotify.NotifyTriggerChance;
+		const int32 FilterLOD = MontageNotify.NotifyFilterType == ENotifyFilterType::LOD ? MontageNotify.NotifyFilterLOD : INDEX_NONE;
+		const EAnimNotifyProNetFilter EventNetFilter = MontageNotify.bTriggerOnDedicatedServer ? EAnimNotifyProNetFilter::None : EAnimNotifyProNetFilter::DedicatedServer;
+
+		UAnimNotifyPro* Notify = MontageNotify.Notify ? Cast<UAnimNotifyPro>(MontageNotify.Notify) : nullptr;
+		UAnimNotifyStatePro* NotifyState = MontageNotify.NotifyStateClass ? Cast<UAnimNotifyStatePro>(MontageNotify.NotifyStateClass) : nullptr;
+		if (!Notify && !NotifyState)
+		{
+			continue;
+		}
+
+		const int32 SectionIndex = Montage->GetSectionIndexFromPosition(NotifyTime);
+		if (!Buckets.IsValidIndex(SectionIndex))
+		{
+			continue;
+		}
+		TArray<FAnimNotifyProScheduleEntry>& Bucket = Buckets[SectionIndex];
+
+		if (Notify)
+		{
+			FAnimNotifyProScheduleEntry& Entry = Bucket.AddDefaulted_GetRef();
+			Entry.Notify = Notify;
+			Entry.Time = NotifyTime;
+			Entry.EnsureTriggerNotify = Notify->EnsureTriggerNotify;
+			Entry.NotifyIndex = NotifyIndex;
+			Entry.NetFilter = Notify->GetNetFilter() | EventNetFilter;
+			Entry.TriggerChance = TriggerChance;
+			Entry.FilterLOD = FilterLOD;
+			Entry.bCritical = Notify->bCritical;
+			Entry.NotifyType = EAnimNotifyProType::Notify;
+		}
+
+		if (NotifyState)
 		{
-			// Only if section is the same as the one we are playing
-			const int32 SectionIndexAtTime = Montage->GetSectionIndexFromPosition(NotifyTime);
-			if (SectionIndexAtTime != SectionIndex)
+			const float NotifyDuration = MontageNotify.GetDuration();
+			const EAnimNotifyProNetFilter NetFilter = NotifyState->GetNetFilter() | EventNetFilter;
+			const int32 BeginIndex = Bucket.Num();
+			const int32 EndIndex = BeginIndex + 1;
+
+			FAnimNotifyProScheduleEntry& BeginEntry = Bucket.AddDefaulted_GetRef();
+			BeginEntry.NotifyState = NotifyState;
+			BeginEntry.Time = NotifyTime;
+			BeginEntry.Duration = NotifyDuration;
+			BeginEntry.EnsureTriggerNotify = NotifyState->EnsureTriggerNotify;
+			BeginEntry.PairIndex = EndIndex;
+			BeginEntry.NotifyIndex = NotifyIndex;
+			BeginEntry.NetFilter = NetFilter;
+			BeginEntry.TriggerChance = TriggerChance;
+			BeginEntry.FilterLOD = FilterLOD;
+			BeginEntry.bCritical = NotifyState->bCritical;
+			BeginEntry.NotifyType = EAnimNotifyProType::NotifyStateBegin;
+
+			FAnimNotifyProScheduleEntry& EndEntry = Bucket.AddDefaulted_GetRef();
+			EndEntry.NotifyState = NotifyState;
+			EndEntry.Time = NotifyTime + NotifyDuration;
+			EndEntry.EnsureTriggerNotify = NotifyState->EnsureTriggerNotify;
+			EndEntry.PairIndex = BeginIndex;
+			EndEntry.NotifyIndex = NotifyIndex;
+			EndEntry.NetFilter = NetFilter;
+			EndEntry.TriggerChance = TriggerChance;
+			EndEntry.FilterLOD = FilterLOD;
+			EndEntry.bCritical = NotifyState->bCritical;
+			EndEntry.NotifyType = EAnimNotifyProType::NotifyStateEnd;
+		}
+	}
+
+	// Flatten the buckets, sorting each by time and remapping the paired indices to the flattened entries
+	OutSchedule.Sections.SetNum(NumSections);
+	for (int32 SectionIndex = 0; SectionIndex < NumSections; SectionIndex++)
+	{
+		const TArray<FAnimNotifyProScheduleEntry>& Bucket = Buckets[SectionIndex];
+		const int32 FirstEntry = OutSchedule.Entries.Num();
+
+		TArray<int32> Order;
+		Order.SetNumUninitialized(Bucket.Num());
+		for (int32 i = 0; i < Order.Num(); i++)
+		{
+			Order[i] = i;
+		}
+		// Events at the same time fire notifies first, then state begins, then state ends, then in track order
+		Algo::StableSort(Order, [&Bucket, &MontageNotifies](int32 A, int32 B)
+		{
+			const FAnimNotifyProScheduleEntry& EntryA = Bucket[A];
+			const FAnimNotifyProScheduleEntry& EntryB = Bucket[B];
+			if (EntryA.Time != EntryB.Time)
 			{
-				continue;
+				return EntryA.Time < EntryB.Time;
+			}
+			if (EntryA.NotifyType != EntryB.NotifyType)
+			{
+				return EntryA.NotifyType < EntryB.NotifyType;
 			}
-			
-			// Create notify event
-			FAnimNotifyProEvent NotifyEvent = { TaskOwner, ++NotifyId, Notify->EnsureTriggerNotify,
-				EAnimNotifyProType::Notify, StartTime, NotifyDuration };
+			return MontageNotifies[EntryA.NotifyIndex].TrackIndex < MontageNotifies[EntryB.NotifyIndex].TrackIndex;
+		});
+
+		TArray<int32> Remap;
+		Remap.SetNumUninitialized(Bucket.Num());
+		for (int32 i = 0; i < Order.Num(); i++)
+		{
+			Remap[Order[i]] = FirstEntry + i;
+		}
+
+		for (const int32 Index : Order)
+		{
+			FAnimNotifyProScheduleEntry& Entry = OutSchedule.Entries.Add_GetRef(Bucket[Index]);
+			Entry.PairIndex = Entry.PairIndex != INDEX_NONE ? Remap[Entry.PairIndex] : INDEX_NONE;
+			OutSchedule.NetFilters |= Entry.NetFilter;
+			OutSchedule.bHasTriggerFilters |= Entry.TriggerChance < 1.f || Entry.FilterLOD != INDEX_NONE;
+			OutSchedule.bHasSignificanceFilters |= PlayMontagePro::IsSignificanceFiltered(Entry);
+		}
+
+		OutSchedule.Sections[SectionIndex].FirstEntry = FirstEntry;
+		OutSchedule.Sections[SectionIndex].NumEntries = Bucket.Num();
+	}
+}
+
+void UPlayMontageProStatics::GatherNotifies(const UObject* TaskOwner, UAnimMontage* Montage, FAnimNotifyProTimeline& Timeline,
+	const FName& Section, float StartPosition)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::GatherNotifies);
+	PLAYMONTAGEPRO_SCOPE_TIME(Gather);
+
+	// Events resolve their notifies through the schedule, the montage keeps the notifies instanced within it alive
+	Timeline.Montage = Montage;
+
+	// Looked up once so callbacks don't have to search the anim instance's montage instances when they fire
+	const FAnimMontageInstance* MontageInstance = GetMontageInstance(Timeline.GetInterface());
+	Timeline.MontageInstanceID = MontageInstance ? MontageInstance->GetInstanceID() : INDEX_NONE;
+
+	// The schedule is built once per montage and gathered whole, sections and seeks only move the clock between its ranges
+	const TSharedRef<const FAnimNotifyProSchedule> Schedule = UPlayMontageProScheduleCache::FindOrBuildSchedule(Montage);
+	if (Timeline.Schedule.Get() != &Schedule.Get())
+	{
+		// Timers bound to the previous events no longer resolve
+		Timeline.EventGeneration++;
+
+		FAnimNotifyProEventArray& Notifies = Timeline.Notifies;
+		Notifies.Reset(Schedule->Entries.Num());
+		for (const FAnimNotifyProScheduleEntry& Entry : Schedule->Entries)
+		{
+			// Create notify event, the notify, duration and pair stay on the entry at the same index.
+			// Pairs resolve by index to the live event, copies of the events would let their bHasBroadcast/bNotifySkipped
+			// flags go stale relative to the entries in Notifies, which caused the begin state to broadcast twice.
+			Notifies.Emplace(++Timeline.NotifyId, Entry.NotifyType, Entry.Time);
+		}
+
+		for (TBitArray<>& Pending : Timeline.PendingEnsure)
+		{
+			Pending.Init(false, Notifies.Num());
+		}
+		Timeline.PendingEndStates.Init(false, Notifies.Num());
+		Timeline.Schedule = Schedule;
+		Timeline.GatheredMontage = Montage;
+	}
 
-			// Cache notify
-			NotifyEvent.Notify = Notify;
-			
-			// Add to notifies list
-			Notifies.Add(NotifyEvent);
+	// Events that can't fire where the montage plays, are above the mesh's LOD, lose their chance roll or are non-critical on an insignificant mesh
+	// are filtered out for the whole play, so they never arm a timer or get ensured
+	if (Schedule->NetFilters != EAnimNotifyProNetFilter::None || Schedule->bHasTriggerFilters || Schedule->bHasSignificanceFilters)
+	{
+		const IPlayMontageProInterface* Interface = Timeline.GetInterface();
+		const USkeletalMeshComponent* MeshComp = Interface ? Interface->GetMesh() : nullptr;
+		const EAnimNotifyProNetFilter NetContext = PlayMontagePro::GetNetContext(MeshComp);
+		const int32 PredictedLOD = MeshComp ? MeshComp->GetPredictedLODLevel() : 0;
+		const bool bInsignificant = Schedule->bHasSignificanceFilters && !IsSignificant(MeshComp);
+		for (int32 Index = 0; Index < Timeline.Notifies.Num(); Index++)
+		{
+			const FAnimNotifyProScheduleEntry& Entry = Schedule->Entries[Index];
+			Timeline.Notifies[Index].bFiltered = EnumHasAnyFlags(Entry.NetFilter, NetContext)
+				|| !PlayMontagePro::PassesTriggerFilters(Timeline, Entry, PredictedLOD)
+				|| (bInsignificant && PlayMontagePro::IsSignificanceFiltered(Entry));
 		}
+	}
+
+	PLAYMONTAGEPRO_COUNT(EventsGathered, Timeline.Notifies.Num());
+
+	// Everything in the section starts pending, events are removed from the bitsets as they fire or are skipped
+	PlayMontagePro::EnterSection(Timeline, Montage, Montage->GetSectionIndex(Section), StartPosition);
+}
+
+void UPlayMontageProStatics::HandleHistoricNotifies(FAnimNotifyProTimeline& Timeline,
+	bool bTriggerNotifiesBeforeStartTime, IPlayMontageProInterface* Interface)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::TriggerHistoricNotifies);
+
+	// Trigger notifies before start time and remove them, if we want to trigger them before the start time
+	// The clock hasn't started yet, so its reading is the start position
+	const float StartTime = Timeline.ClockBase;
+	Timeline.bTriggerNotifiesBeforeStartTime = bTriggerNotifiesBeforeStartTime;
 
-		// Add notify states to the list of notifies
-		if (UAnimNotifyStatePro* Notify = MontageNotify.NotifyStateClass ? Cast<UAnimNotifyStatePro>(MontageNotify.NotifyStateClass) : nullptr)
+	// Events are sorted by time, so only those up to the start time have to be visited
+	FAnimNotifyProEventArray& Notifies = Timeline.Notifies;
+	const int32 FirstEventAfter = PlayMontagePro::FindFirstEventAfter(Timeline, StartTime);
+	for (int32 Index = Timeline.Cursor; Index < FirstEventAfter; Index++)
+	{
+		FAnimNotifyProEvent& Notify = Notifies[Index];
+		if (!PlayMontagePro::IsPendingNotify(Notify))
+		{
+			continue;
+		}
+		
+		if (FMath::IsNearlyEqual(Notify.Time, StartTime, UE_KINDA_SMALL_NUMBER))
 		{
-			// Only if section is the same as the one we are playing
-			const int32 SectionIndexAtTime = Montage->GetSectionIndexFromPosition(NotifyTime);
-			if (SectionIndexAtTime != SectionIndex)
+			BroadcastNotifyEvent(Timeline, Notify, Interface);
+			continue;
+		}
+		
+		if (Notify.Time < StartTime)
+		{
+			if (bTriggerNotifiesBeforeStartTime)
 			{
-				continue;
+				BroadcastNotifyEvent(Timeline, Notify, Interface, EAnimNotifyProTrigger::Historic);
 			}
-			
-			// Compute end time for the notify end state
-			const float EndTime = StartTime + NotifyDuration;
-
-			// Start state notify
-			FAnimNotifyProEvent NotifyBeginEvent = { TaskOwner, ++NotifyId, Notify->EnsureTriggerNotify,
-				EAnimNotifyProType::NotifyStateBegin, StartTime, NotifyDuration };
-
-			// Start state notify
-			FAnimNotifyProEvent NotifyEndEvent = { TaskOwner, ++NotifyId, Notify->EnsureTriggerNotify,
-				EAnimNotifyProType::NotifyStateEnd, EndTime };
-			
-			// Mark as end state
-			NotifyEndEvent.bIsEndState = true;
-
-			// Cache notify state
-			NotifyBeginEvent.NotifyState = Notify;
-			NotifyEndEvent.NotifyState = Notify;
-
-			// Add to notifies list
-			int32 BeginIndex = Notifies.Add(NotifyBeginEvent);
-			int32 EndIndex = Notifies.Add(NotifyEndEvent);
-
-			// Pair begin and end states by NotifyId so the pair always resolves to the live event.
-			// Storing copies of the events here would let their bHasBroadcast/bNotifySkipped flags go
-			// stale relative to the entries in Notifies, which caused the begin state to broadcast twice.
-			if (ensure(Notifies[BeginIndex].IsValidEvent() && Notifies[EndIndex].IsValidEvent()))
+			else
 			{
-				NotifyStatePairs.Add(Notifies[BeginIndex].NotifyId, Notifies[EndIndex].NotifyId);
-				NotifyStatePairs.Add(Notifies[EndIndex].NotifyId, Notifies[BeginIndex].NotifyId);
+				Notify.bNotifySkipped = true;
+				PlayMontagePro::ClearPendingEnsure(Timeline, Index);
+				PLAYMONTAGEPRO_COUNT(EventsSkipped, 1);
+				TRACE_PLAYMONTAGEPRO_NOTIFY(Skipped, Timeline, Index, 0);
+
+				// An end state can never fire once its begin state is skipped
+				const int32 PairIndex = Timeline.GetEntry(Index).PairIndex;
+				if (Notify.NotifyType == EAnimNotifyProType::NotifyStateBegin && Notifies.IsValidIndex(PairIndex))
+				{
+					PlayMontagePro::ClearPendingEnsure(Timeline, PairIndex);
+				}
 			}
 		}
 	}
-}
 
-FAnimNotifyProEvent* UPlayMontageProStatics::FindNotifyById(TArray<FAnimNotifyProEvent>& Notifies, uint32 NotifyId)
-{
-	if (NotifyId == 0)
+	// Everything before the start time has now fired or been skipped
+	Timeline.Cursor = FMath::Max(Timeline.Cursor, FirstEventAfter);
+}
+
+EAnimNotifyProScheduleMode UPlayMontageProStatics::GetScheduleMode()
+{
+	return static_cast<EAnimNotifyProScheduleMode>(FMath::Clamp(GPlayMontageProScheduleMode, 0, static_cast<int32>(EAnimNotifyProScheduleMode::Tick)));
+}
+
+bool UPlayMontageProStatics::ShouldPollTimeDilation()
+{
+	return GPlayMontageProPollTimeDilation;
+}
+
+FPlayMontageProSignificanceDelegate UPlayMontageProStatics::SignificanceDelegate;
+
+float UPlayMontageProStatics::GetSignificance(const USkeletalMeshComponent* MeshComp)
+{
+	if (!MeshComp)
+	{
+		return 1.f;
+	}
+
+	if (SignificanceDelegate.IsBound())
+	{
+		return SignificanceDelegate.Execute(MeshComp);
+	}
+
+	// Nothing renders on a dedicated server, so visibility can't tell it anything
+	if (GPlayMontageProSignificanceUseVisibility && MeshComp->GetNetMode() != NM_DedicatedServer)
+	{
+		return MeshComp->WasRecentlyRendered() ? 1.f : 0.f;
+	}
+	return 1.f;
+}
+
+bool UPlayMontageProStatics::IsSignificant(const USkeletalMeshComponent* MeshComp)
+{
+	return GetSignificance(MeshComp) >= GPlayMontageProSignificanceThreshold;
+}
+
+void UPlayMontageProStatics::SetupNotifyTimers(IPlayMontageProInterface* Interface, const UWorld* World,
+	FAnimNotifyProTimeline& Timeline)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::SetupNotifyTimers);
+	PLAYMONTAGEPRO_SCOPE_TIME(Setup);
+
+	// Fixed until the timers are next set up, so toggling the cvar doesn't strand timers that are already armed
+	Timeline.ScheduleMode = GetScheduleMode();
+
+	// The clock starts now from the position the section was entered at
+	const double WorldTime = World->GetTimeSeconds();
+	Timeline.ClockWorldTime = WorldTime;
+
+	if (Timeline.UsesCursor())
+	{
+		// Events are time-sorted, so we only ever need to wake up for the next one
+		ArmNotifyCursor(World, Timeline);
+		return;
+	}
+
+	for (int32 Index = Timeline.SectionBegin; Index < Timeline.SectionEnd; Index++)
+	{
+		const FAnimNotifyProEvent& Notify = Timeline.Notifies[Index];
+		if (!PlayMontagePro::IsPendingNotify(Notify))
+		{
+			continue;
+		}
+
+		// Set up timer for notify, it is armed once the clock runs if it is stopped
+		// Its handle stops late timers from reaching events gathered since
+		const float Delay = PlayMontagePro::GetNotifyDelay(Timeline, Notify, WorldTime);
+		if (Delay > 0.f)
+		{
+			PlayMontagePro::ArmNotifyTimer(World, Timeline, Index, Delay);
+		}
+	}
+}
+
+void UPlayMontageProStatics::ClearNotifyTimers(const UWorld* World, FAnimNotifyProTimeline& Timeline)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::ForfeitNotifyTimers);
+
+	// Lets a dispatch in progress know to stop, and orphans any entry in the subsystem's heap
+	Timeline.Serial++;
+	Timeline.NextDueTime = -1.0;
+
+	if (Timeline.CursorTimer.IsValid())
+	{
+		PlayMontagePro::ClearNotifyTimer(World, Timeline.CursorTimer);
+	}
+	
+	for (FAnimNotifyProEvent& Notify : Timeline.Notifies)
+	{
+		if (Notify.Timer.IsValid())
+		{
+			// Clear the timer for this notify
+			PlayMontagePro::ClearNotifyTimer(World, Notify.Timer);
+			Notify.ClearTimers();
+		}
+	}
+}
+
+void UPlayMontageProStatics::ArmNotifyCursor(const UWorld* World, FAnimNotifyProTimeline& Timeline)
+{
+	FAnimNotifyProEventArray& Notifies = Timeline.Notifies;
+
+	// Skip anything already handled, e.g. historic notifies or begin states broadcast early by their end state
+	while (Timeline.Cursor < Timeline.SectionEnd && !PlayMontagePro::IsPendingNotify(Notifies[Timeline.Cursor]))
+	{
+		Timeline.Cursor++;
+	}
+
+	if (Timeline.SectionIndex == INDEX_NONE)
+	{
+		PlayMontagePro::ClearNotifyTimer(World, Timeline.CursorTimer);
+		Timeline.NextDueTime = -1.0;
+		return;
+	}
+
+	// With nothing left in the section, wake up at its end to follow the montage into its next section
+	// Once past the end there is no link to follow, OnMontageSectionChanged or the montage ending takes over
+	const double WorldTime = World->GetTimeSeconds();
+	const bool bSectionDone = Timeline.Cursor >= Timeline.SectionEnd;
+	if (bSectionDone && Timeline.GetClockTime(WorldTime) >= Timeline.SectionEndTime - UE_KINDA_SMALL_NUMBER)
+	{
+		PlayMontagePro::ClearNotifyTimer(World, Timeline.CursorTimer);
+		Timeline.NextDueTime = -1.0;
+		return;
+	}
+
+	// Nothing is due while the clock is stopped, it is re-armed when the rate changes
+	const float DueClockTime = bSectionDone ? Timeline.SectionEndTime : Notifies[Timeline.Cursor].Time;
+	const float Delay = PlayMontagePro::GetClockDelay(Timeline, DueClockTime, WorldTime);
+	if (Delay < 0.f)
+	{
+		PlayMontagePro::ClearNotifyTimer(World, Timeline.CursorTimer);
+		Timeline.NextDueTime = -1.0;
+		return;
+	}
+
+	// The cursor is re-armed for the same event by retimes and seeks, only its first schedule is traced
+	if (!bSectionDone && !Notifies[Timeline.Cursor].bArmed)
 	{
-		return nullptr;
+		Notifies[Timeline.Cursor].bArmed = true;
+		TRACE_PLAYMONTAGEPRO_NOTIFY(Armed, Timeline, Timeline.Cursor, Timeline.ScheduleMode);
 	}
 
-	for (FAnimNotifyProEvent& Notify : Notifies)
+	if (Timeline.ScheduleMode == EAnimNotifyProScheduleMode::Tick)
 	{
-		if (Notify.NotifyId == NotifyId)
+		if (UPlayMontageProSubsystem* Subsystem = UPlayMontageProSubsystem::Get(World))
 		{
-			return &Notify;
+			Subsystem->ScheduleTimeline(Timeline, WorldTime + Delay);
 		}
+		return;
 	}
-	return nullptr;
-}
 
-FAnimNotifyProEvent* UPlayMontageProStatics::FindNotifyStatePair(TArray<FAnimNotifyProEvent>& Notifies,
-	const TMap<uint32, uint32>& NotifyStatePairs, const FAnimNotifyProEvent& Event)
-{
-	const uint32* PairedId = NotifyStatePairs.Find(Event.NotifyId);
-	return PairedId ? FindNotifyById(Notifies, *PairedId) : nullptr;
+	PlayMontagePro::SetNotifyTimer(World, UPlayMontageProSubsystem::Get(World), Timeline.CursorTimer, Timeline.CursorTimerDelegate, Delay);
 }
 
-void UPlayMontageProStatics::HandleHistoricNotifies(TArray<FAnimNotifyProEvent>& Notifies,
-	const TMap<uint32, uint32>& NotifyStatePairs, bool bTriggerNotifiesBeforeStartTime,
-	float StartTime, IPlayMontageProInterface* Interface)
+void UPlayMontageProStatics::DispatchDueNotifies(IPlayMontageProInterface* Interface, const UWorld* World,
+	FAnimNotifyProTimeline& Timeline)
 {
-	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::TriggerHistoricNotifies);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::DispatchDueNotifies);
+	PLAYMONTAGEPRO_SCOPE_TIME(Dispatch);
 
-	// Trigger notifies before start time and remove them, if we want to trigger them before the start time
-	for (FAnimNotifyProEvent& Notify : Notifies)
+	// The play rate, position or CustomTimeDilation may have been changed directly, pick them up before deciding what is due
+	if (PlayMontagePro::SyncWithMontageInstance(Interface, World, Timeline))
 	{
-		FAnimNotifyProEvent* NotifyStatePair = FindNotifyStatePair(Notifies, NotifyStatePairs, Notify);
-		
-		if (FMath::IsNearlyEqual(Notify.Time, StartTime, UE_KINDA_SMALL_NUMBER))
+		return;
+	}
+
+	// Only looked up when PlayMontagePro.DispatchBudget.Ms is set, callbacks are then timed against it
+	UPlayMontageProSubsystem* BudgetSubsystem = UPlayMontageProSubsystem::HasDispatchBudget() ? UPlayMontageProSubsystem::Get(World) : nullptr;
+
+	const uint32 Serial = Timeline.Serial;
+	bool bFollowedSection = false;
+	while (true)
+	{
+		// Only one link is followed per dispatch, so a short looping section can't stall the frame
+		if (Timeline.Cursor >= Timeline.SectionEnd)
 		{
-			BroadcastNotifyEvent(Notify, NotifyStatePair, Interface);
+			if (bFollowedSection || !PlayMontagePro::FollowNextSection(Interface, Timeline, World->GetTimeSeconds()))
+			{
+				break;
+			}
+			bFollowedSection = true;
 			continue;
 		}
-		
-		if (Notify.Time < StartTime)
+
+		// Re-evaluated per event, a callback may change the play rate
+		const float Elapsed = Timeline.GetClockTime(World->GetTimeSeconds());
+		FAnimNotifyProEvent& Event = Timeline.Notifies[Timeline.Cursor];
+		if (PlayMontagePro::IsPendingNotify(Event) && Event.Time > Elapsed + UE_KINDA_SMALL_NUMBER)
 		{
-			if (bTriggerNotifiesBeforeStartTime)
-			{
-				BroadcastNotifyEvent(Notify, NotifyStatePair, Interface);
-			}
-			else
-			{
-				Notify.bNotifySkipped = true;
-			}
+			break;
+		}
+
+		// Advance first, the callback may end the montage and clear or release the timeline
+		// The timeline is already resolved, so the event is broadcast directly rather than through the interface
+		const int32 Index = Timeline.Cursor++;
+		if (PlayMontagePro::IsPendingNotify(Event))
+		{
+			PlayMontagePro::BroadcastWithinBudget(BudgetSubsystem, Timeline, Index, Interface);
+		}
+
+		if (Timeline.Serial != Serial)
+		{
+			return;
 		}
 	}
+
+	ArmNotifyCursor(World, Timeline);
 }
 
-void UPlayMontageProStatics::SetupNotifyTimers(IPlayMontageProInterface* Interface, const UWorld* World,
-	TArray<FAnimNotifyProEvent>& Notifies)
+void UPlayMontageProStatics::DispatchDueTimerNotifies(IPlayMontageProInterface* Interface, const UWorld* World,
+	FAnimNotifyProTimeline& Timeline, int32 EventIndex)
 {
-	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::SetupNotifyTimers);
-	
-	for (FAnimNotifyProEvent& Notify : Notifies)
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::DispatchDueTimerNotifies);
+	PLAYMONTAGEPRO_SCOPE_TIME(Dispatch);
+
+	FAnimNotifyProEvent& TimerEvent = Timeline.Notifies[EventIndex];
+	if (EventIndex < Timeline.SectionBegin || EventIndex >= Timeline.SectionEnd)
 	{
-		// Set up timer for notify
-		Notify.TimerDelegate = Interface->CreateTimerDelegate(Notify);
-		World->GetTimerManager().SetTimer(Notify.Timer, Notify.TimerDelegate, Notify.Time, false);
+		BroadcastNotifyEvent(Timeline, TimerEvent, Interface);
+		return;
 	}
-}
 
-void UPlayMontageProStatics::ClearNotifyTimers(const UWorld* World, TArray<FAnimNotifyProEvent>& Notifies)
-{
-	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::ForfeitNotifyTimers);
-	
-	for (FAnimNotifyProEvent& Notify : Notifies)
+	// The play rate, position or CustomTimeDilation may have been changed directly, pick them up before deciding what is due
+	const FTimerHandle FiredTimer = TimerEvent.Timer;
+	if (PlayMontagePro::SyncWithMontageInstance(Interface, World, Timeline))
 	{
-		if (Notify.Timer.IsValid())
+		return;
+	}
+
+	// Every event the clock has reached fires now in schedule order, rather than in whichever order the timer manager runs their timers
+	// The fired event is due regardless of rounding, unless picking up a change re-armed its timer for later
+	const float ClockTime = Timeline.GetClockTime(World->GetTimeSeconds());
+	const float DueTime = TimerEvent.Timer == FiredTimer ? FMath::Max(ClockTime, TimerEvent.Time) : ClockTime;
+	const int32 FirstEventAfter = PlayMontagePro::FindFirstEventAfter(Timeline, DueTime);
+	UPlayMontageProSubsystem* BudgetSubsystem = UPlayMontageProSubsystem::HasDispatchBudget() ? UPlayMontageProSubsystem::Get(World) : nullptr;
+	const uint32 Serial = Timeline.Serial;
+	for (int32 Index = Timeline.SectionBegin; Index < FirstEventAfter; Index++)
+	{
+		FAnimNotifyProEvent& Event = Timeline.Notifies[Index];
+		if (!PlayMontagePro::IsPendingNotify(Event))
 		{
-			// Clear the timer for this notify
-			World->GetTimerManager().ClearTimer(Notify.Timer);
-			Notify.ClearTimers();
+			continue;
+		}
+
+		// Its own timer would only find it already broadcast
+		if (Event.Timer.IsValid())
+		{
+			PlayMontagePro::ClearNotifyTimer(World, Event.Timer);
+		}
+
+		// The callback may end the montage and clear or release the timeline
+		PlayMontagePro::BroadcastWithinBudget(BudgetSubsystem, Timeline, Index, Interface);
+		if (Timeline.Serial != Serial)
+		{
+			return;
 		}
 	}
 }
 
-void UPlayMontageProStatics::BroadcastNotifyEvent(FAnimNotifyProEvent& Event, FAnimNotifyProEvent* NotifyStatePair, IPlayMontageProInterface* Interface)
+void UPlayMontageProStatics::BroadcastNotifyEvent(FAnimNotifyProTimeline& Timeline, FAnimNotifyProEvent& Event, IPlayMontageProInterface* Interface,
+	EAnimNotifyProTrigger Trigger)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::BroadcastNotifyEvent);
 	
-	// Ensure we don't broadcast the same event twice
-	if (Event.bHasBroadcast || Event.bNotifySkipped)
+	// Ensure we don't broadcast the same event twice, or at all if it was filtered out
+	if (Event.bHasBroadcast || Event.bNotifySkipped || Event.bFiltered)
 	{
 		return;
 	}
 
 	// Ensure the start state broadcasts first if this is the end state
+	FAnimNotifyProEvent* NotifyStatePair = FindNotifyStatePair(Timeline, Event);
 	if (Event.bIsEndState && NotifyStatePair)
 	{
 		// If our start state was skipped, we can't broadcast the end state
@@ -206,106 +967,461 @@ void UPlayMontageProStatics::BroadcastNotifyEvent(FAnimNotifyProEvent& Event, FA
 			return;
 		}
 
-		// Broadcast the start state first
+		// Broadcast the start state first, its callback may end the montage and release the timeline
 		if (!NotifyStatePair->bHasBroadcast)
 		{
-			BroadcastNotifyEvent(*NotifyStatePair, nullptr, Interface);
+			const uint32 Serial = Timeline.Serial;
+			BroadcastNotifyEvent(Timeline, *NotifyStatePair, Interface, Trigger);
+			if (Timeline.Serial != Serial)
+			{
+				return;
+			}
 		}
 	}
 
-	// Mark the event as broadcast and clear timers
+	// Mark the event as broadcast and clear timers, an end state may broadcast its deferred begin state ahead of the queue
 	Event.bHasBroadcast = true;
-	Event.ClearTimers();
+	Event.bDeferred = false;
+	if (Event.Timer.IsValid())
+	{
+		// Broadcast ahead of its timer, e.g. when ensured. Without a world the handle is kept, so the timer is still cleared and uncounted on release
+		const USkeletalMeshComponent* Mesh = Interface ? Interface->GetMesh() : nullptr;
+		if (const UWorld* World = Mesh ? Mesh->GetWorld() : nullptr)
+		{
+			PlayMontagePro::ClearNotifyTimer(World, Event.Timer);
+		}
+	}
+
+	// Traced once, as either ensured or fired
+	if (Trigger == EAnimNotifyProTrigger::Ensured)
+	{
+		PLAYMONTAGEPRO_COUNT(EventsEnsured, 1);
+		TRACE_PLAYMONTAGEPRO_NOTIFY(Ensured, Timeline, Timeline.GetEventIndex(Event), Timeline.EnsureEventType);
+	}
+	else
+	{
+		PLAYMONTAGEPRO_COUNT(EventsFired, 1);
+		TRACE_PLAYMONTAGEPRO_NOTIFY(Fired, Timeline, Timeline.GetEventIndex(Event), Trigger);
+	}
+
+	// Nothing is left to ensure for this event, but a begin state now needs its end state ensured
+	const FAnimNotifyProScheduleEntry& Entry = Timeline.GetEntry(Event);
+	PlayMontagePro::ClearPendingEnsure(Timeline, Timeline.GetEventIndex(Event));
+	if (Event.NotifyType == EAnimNotifyProType::NotifyStateBegin && NotifyStatePair && !NotifyStatePair->bHasBroadcast)
+	{
+		Timeline.PendingEndStates[Entry.PairIndex] = true;
+	}
+
+	// Nothing to build the context for if there is no callback to receive it
+	if (!Timeline.Owner.IsValid() || (Event.NotifyType == EAnimNotifyProType::Notify ? !Entry.Notify : !Entry.NotifyState))
+	{
+		return;
+	}
 
 	// Broadcast notify callback
+	USkeletalMeshComponent* MeshComp = Interface->GetMesh();
+	const FAnimNotifyProContext Context = MakeNotifyContext(Timeline, Event, MeshComp ? MeshComp->GetWorld() : nullptr, Trigger);
 	switch (Event.NotifyType)
 	{
 	case EAnimNotifyProType::Notify:
-		if (Event.Notify && Event.TaskOwner.IsValid())
-		{
-			Event.Notify->NotifyCallback(Interface->GetMesh(), Interface->GetMontage());
-		}
+		Entry.Notify->NotifyCallback(MeshComp, Interface->GetMontage(), Context);
 		break;
 	case EAnimNotifyProType::NotifyStateBegin:
-		if (Event.NotifyState && Event.TaskOwner.IsValid())
+		// Opened before the callback, which may end the montage, in which case the window closes without ticking
+		// Ensured begin states end straight away, so they never tick
+		if (Trigger != EAnimNotifyProTrigger::Ensured && Entry.NotifyState->WantsProTick())
 		{
-			Event.NotifyState->NotifyBeginCallback(Interface->GetMesh(), Interface->GetMontage(), Event.Duration);
+			if (UPlayMontageProSubsystem* Subsystem = UPlayMontageProSubsystem::Get(MeshComp ? MeshComp->GetWorld() : nullptr))
+			{
+				Subsystem->OpenTickWindow(Timeline, Timeline.GetEventIndex(Event));
+			}
 		}
+		Entry.NotifyState->NotifyBeginCallback(MeshComp, Interface->GetMontage(), Entry.Duration, Context);
 		break;
 	case EAnimNotifyProType::NotifyStateEnd:
-		if (Event.NotifyState && Event.TaskOwner.IsValid())
-		{
-			Event.NotifyState->NotifyEndCallback(Interface->GetMesh(), Interface->GetMontage());
-		}
+		Entry.NotifyState->NotifyEndCallback(MeshComp, Interface->GetMontage(), Context);
 		break;
 	}
 }
 
-void UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType EventType,	TArray<FAnimNotifyProEvent>& Notifies,
-	const TMap<uint32, uint32>& NotifyStatePairs, IPlayMontageProInterface* Interface)
+FAnimNotifyProContext UPlayMontageProStatics::MakeNotifyContext(const FAnimNotifyProTimeline& Timeline, const FAnimNotifyProEvent& Event,
+	const UWorld* World, EAnimNotifyProTrigger Trigger)
+{
+	FAnimNotifyProContext Context;
+	Context.ScheduledTime = Event.Time;
+	Context.EffectiveRate = Timeline.GetClockRate();
+	Context.FireWorldTime = World ? World->GetTimeSeconds() : Timeline.ClockWorldTime;
+	Context.MontagePosition = Timeline.GetClockTime(Context.FireWorldTime);
+	Context.SectionIndex = Timeline.SectionIndex;
+	Context.MontageInstanceID = Timeline.MontageInstanceID;
+	Context.Trigger = Trigger;
+
+	// Historic and ensured events are behind or ahead of the clock by design, only scheduled ones can be late
+	if (Trigger == EAnimNotifyProTrigger::Scheduled)
+	{
+		Context.Lateness = FMath::Max(0.f, Context.MontagePosition - Event.Time);
+	}
+
+	if (Timeline.Montage && Timeline.Montage->IsValidSectionIndex(Timeline.SectionIndex))
+	{
+		Context.SectionName = Timeline.Montage->GetSectionName(Timeline.SectionIndex);
+	}
+	return Context;
+}
+
+FAnimNotifyProContext UPlayMontageProStatics::MakeLegacyNotifyContext(const USkeletalMeshComponent* MeshComp, const UAnimMontage* Montage,
+	const FAnimNotifyEventReference& EventReference, bool bEndState)
+{
+	FAnimNotifyProContext Context;
+	Context.Trigger = EAnimNotifyProTrigger::Legacy;
+	if (const FAnimNotifyEvent* NotifyEvent = EventReference.GetNotify())
+	{
+		Context.ScheduledTime = bEndState ? NotifyEvent->GetEndTriggerTime() : NotifyEvent->GetTriggerTime();
+	}
+
+	if (const UWorld* World = MeshComp ? MeshComp->GetWorld() : nullptr)
+	{
+		Context.FireWorldTime = World->GetTimeSeconds();
+	}
+
+	// The engine doesn't tell us how late the notify is, the montage instance is the best we have
+	const UAnimInstance* AnimInstance = MeshComp ? MeshComp->GetAnimInstance() : nullptr;
+	const FAnimMontageInstance* MontageInstance = AnimInstance && Montage ? AnimInstance->GetActiveInstanceForMontage(Montage) : nullptr;
+	if (MontageInstance)
+	{
+		Context.MontagePosition = MontageInstance->GetPosition();
+		Context.EffectiveRate = MontageInstance->GetPlayRate();
+		Context.MontageInstanceID = MontageInstance->GetInstanceID();
+		Context.SectionIndex = Montage->GetSectionIndexFromPosition(Context.MontagePosition);
+		Context.SectionName = Montage->GetSectionName(Context.SectionIndex);
+	}
+	else
+	{
+		Context.MontagePosition = Context.ScheduledTime;
+	}
+	return Context;
+}
+
+void UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EAnimNotifyProEventType EventType, IPlayMontageProInterface* Interface)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::EnsureBroadcastNotifyEvents);
+
+	FAnimNotifyProTimeline* Timeline = Interface->GetTimeline();
+	if (!Timeline)
+	{
+		return;
+	}
+
+	// Only visit events still pending for this event type, end states whose begin fired are pending for all but blend out.
+	// A callback may end the montage and release the timeline, stop if it does.
+	const bool bEnsureEndStates = EventType != EAnimNotifyProEventType::BlendOut;
+	const uint32 Serial = Timeline->Serial;
+	Timeline->EnsureEventType = EventType;
+	for (int32 Index = PlayMontagePro::FindNextPendingEnsure(*Timeline, EventType, bEnsureEndStates, 0);
+		Index != INDEX_NONE && Timeline->Serial == Serial;
+		Index = PlayMontagePro::FindNextPendingEnsure(*Timeline, EventType, bEnsureEndStates, Index + 1))
+	{
+		Interface->BroadcastNotifyEvent(Timeline->Notifies[Index], EAnimNotifyProTrigger::Ensured);
+	}
+
+	// Left alone if a callback released the timeline, its slot may already belong to another play
+	if (Timeline->Serial == Serial)
+	{
+		Timeline->EnsureEventType = EAnimNotifyProEventType::None;
+	}
+}
+
+void UPlayMontageProStatics::HandleTimeDilation(IPlayMontageProInterface* Interface, const USkinnedMeshComponent* MeshComp,
+	FAnimNotifyProTimeline& Timeline)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::HandleTimeDilation);
 	
-	for (FAnimNotifyProEvent& Event : Notifies)
+	const UWorld* World = MeshComp ? MeshComp->GetWorld() : nullptr;
+	if (!World)
+	{
+		return;
+	}
+
+	// We're polling anyway, so also pick up Montage_SetPlayRate and Montage_Pause calls that bypassed our statics
+	const FAnimMontageInstance* MontageInstance = GetMontageInstance(Interface);
+	const float NewPlayRate = MontageInstance ? MontageInstance->GetPlayRate() : Timeline.PlayRate;
+	SetTimelineRate(World, Timeline, NewPlayRate, MeshComp->GetOwner()->CustomTimeDilation);
+	if (MontageInstance)
+	{
+		SetTimelinePaused(World, Timeline, !MontageInstance->IsPlaying());
+	}
+}
+
+void UPlayMontageProStatics::SetTimelineRate(const UWorld* World, FAnimNotifyProTimeline& Timeline, float PlayRate,
+	float TimeDilation)
+{
+	if (FMath::IsNearlyEqual(Timeline.PlayRate, PlayRate) && FMath::IsNearlyEqual(Timeline.TimeDilation, TimeDilation))
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::SetTimelineRate);
+	PLAYMONTAGEPRO_COUNT(Retimes, 1);
+
+	// Event times are in montage time, so only the clock's rate changes
+	const double WorldTime = World->GetTimeSeconds();
+	const float OldRate = Timeline.GetClockRate();
+	const bool bTimeDilationChanged = !FMath::IsNearlyEqual(Timeline.TimeDilation, TimeDilation);
+	Timeline.RebaseClock(WorldTime);
+	Timeline.PlayRate = PlayRate;
+	Timeline.TimeDilation = TimeDilation;
+	if (bTimeDilationChanged)
+	{
+		TRACE_PLAYMONTAGEPRO_RETIMED(TimeDilation, Timeline, OldRate);
+	}
+	else
+	{
+		TRACE_PLAYMONTAGEPRO_RETIMED(PlayRate, Timeline, OldRate);
+	}
+
+	if (Timeline.UsesCursor())
+	{
+		ArmNotifyCursor(World, Timeline);
+		return;
+	}
+
+	// Legacy per-event timers all have to be re-armed
+	PlayMontagePro::RearmNotifyTimers(World, Timeline);
+}
+
+void UPlayMontageProStatics::SetTimelinePaused(const UWorld* World, FAnimNotifyProTimeline& Timeline, bool bPaused)
+{
+	if (Timeline.bPaused == bPaused)
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::SetTimelinePaused);
+
+	// A paused clock has a rate of zero, so its reading is kept until it resumes
+	const float OldRate = Timeline.GetClockRate();
+	Timeline.RebaseClock(World->GetTimeSeconds());
+	Timeline.bPaused = bPaused;
+	if (bPaused)
+	{
+		TRACE_PLAYMONTAGEPRO_RETIMED(Paused, Timeline, OldRate);
+	}
+	else
+	{
+		TRACE_PLAYMONTAGEPRO_RETIMED(Resumed, Timeline, OldRate);
+	}
+
+	if (Timeline.UsesCursor())
+	{
+		ArmNotifyCursor(World, Timeline);
+		return;
+	}
+
+	// Legacy per-event timers keep their remaining time while paused
+	const double WorldTime = World->GetTimeSeconds();
+	FTimerManager& TimerManager = World->GetTimerManager();
+	for (int32 Index = Timeline.SectionBegin; Index < Timeline.SectionEnd; Index++)
 	{
-		if (Event.bHasBroadcast)
+		FAnimNotifyProEvent& Notify = Timeline.Notifies[Index];
+		if (!PlayMontagePro::IsPendingNotify(Notify))
 		{
 			continue;
 		}
-		
-		// Ensure that notifies are triggered if the montage aborts before they're reached when aborted due to these conditions
-		const EAnimNotifyProEventType EventFlags = static_cast<EAnimNotifyProEventType>(Event.EnsureTriggerNotify);
-		if (EnumHasAnyFlags(EventFlags, EventType))
+
+		if (bPaused)
 		{
-			Interface->BroadcastNotifyEvent(Event);
+			TimerManager.PauseTimer(Notify.Timer);
 		}
-		
-		// Ensure that the end state is reached if the start state notify was triggered
-		const FAnimNotifyProEvent* NotifyStatePair = FindNotifyStatePair(Notifies, NotifyStatePairs, Event);
-		if (EventType != EAnimNotifyProEventType::BlendOut && Event.bIsEndState && NotifyStatePair && NotifyStatePair->bHasBroadcast)
+		else if (TimerManager.IsTimerPaused(Notify.Timer))
+		{
+			TimerManager.UnPauseTimer(Notify.Timer);
+		}
+		else
 		{
-			Interface->BroadcastNotifyEvent(Event);
+			// Cleared by a rate change or timer setup while paused, arm it from the clock
+			const float Delay = PlayMontagePro::GetNotifyDelay(Timeline, Notify, WorldTime);
+			if (Delay > 0.f)
+			{
+				PlayMontagePro::ArmNotifyTimer(World, Timeline, Index, Delay);
+			}
 		}
 	}
 }
 
-void UPlayMontageProStatics::HandleTimeDilation(IPlayMontageProInterface* Interface, const USkinnedMeshComponent* MeshComp,
-	float& TimeDilation, TArray<FAnimNotifyProEvent>& Notifies)
+void UPlayMontageProStatics::SeekTimeline(IPlayMontageProInterface* Interface, const UWorld* World,
+	FAnimNotifyProTimeline& Timeline, float Position)
 {
-	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::HandleTimeDilation);
-	
-	const UWorld* World = MeshComp ? MeshComp->GetWorld() : nullptr;
-	if (!World)
+	const UAnimMontage* Montage = Interface->GetMontage();
+	if (!Montage || !Timeline.Schedule.IsValid())
 	{
 		return;
 	}
-	
-	const float NewTimeDilation = MeshComp->GetOwner()->CustomTimeDilation;
-	if (!FMath::IsNearlyEqual(TimeDilation, NewTimeDilation))
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::SeekTimeline);
+
+	const float ClockTime = Timeline.GetClockTime(World->GetTimeSeconds());
+
+	// Stops a dispatch in progress, the events keep whether they fired
+	ClearNotifyTimers(World, Timeline);
+
+	const int32 SectionIndex = Montage->GetSectionIndexFromPosition(Position);
+	if (SectionIndex != Timeline.SectionIndex)
 	{
-		// If time dilation has changed, we need to update the notifies
-		for (FAnimNotifyProEvent& Notify : Notifies)
+		PlayMontagePro::EnterSection(Timeline, Montage, SectionIndex, Position);
+	}
+	else
+	{
+		// Seeking back within the section replays the events from the new position
+		if (Position < ClockTime)
 		{
-			// Any elapsed time should be maintained, and only remaining time should be updated
-			// Then we need to restart the timer based on the new time, without the already elapsed time
-			// So that only the remaining time is affected by time dilation changes
-			if (Notify.IsValidEvent() && !Notify.bNotifySkipped && !Notify.bHasBroadcast && Notify.Timer.IsValid())
+			const int32 ReplayIndex = PlayMontagePro::FindFirstEventAt(Timeline, Position);
+			for (int32 Index = ReplayIndex; Index < Timeline.SectionEnd; Index++)
 			{
-				const float ElapsedTime = World->GetTimerManager().GetTimerElapsed(Notify.Timer);
-				const float RemainingTime = Notify.Time - ElapsedTime;
-				if (RemainingTime > 0.f)
-				{
-					// Restart the timer with the new time dilation
-					Notify.Time = ElapsedTime + RemainingTime / NewTimeDilation;
-
-					// Clear the previous delegate and bind a new one
-					World->GetTimerManager().ClearTimer(Notify.Timer);
-					Notify.ClearTimers();
-					Notify.TimerDelegate = Interface->CreateTimerDelegate(Notify);
-					World->GetTimerManager().SetTimer(Notify.Timer, Notify.TimerDelegate, Notify.Time, false);
-				}
+				PlayMontagePro::ResetPendingNotify(Timeline, Index);
+			}
+			Timeline.Cursor = FMath::Min(Timeline.Cursor, ReplayIndex);
+		}
+		Timeline.ClockBase = Position;
+	}
+	TRACE_PLAYMONTAGEPRO_RETIMED(Seek, Timeline, Timeline.GetClockRate());
+
+	// Events passed over fire or are skipped as if the montage had started from the position, then only the next one is armed
+	HandleHistoricNotifies(Timeline, Timeline.bTriggerNotifiesBeforeStartTime, Interface);
+	SetupNotifyTimers(Interface, World, Timeline);
+}
+
+void UPlayMontageProStatics::HandleSectionChange(IPlayMontageProInterface* Interface, const UWorld* World,
+	FAnimNotifyProTimeline& Timeline, float Position, bool bLooped)
+{
+	const UAnimMontage* Montage = Interface->GetMontage();
+	if (!Montage)
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProStatics::HandleSectionChange);
+	PLAYMONTAGEPRO_COUNT(SectionChanges, 1);
+
+	const bool bAwaitingSectionChange = Timeline.bAwaitingSectionChange;
+	Timeline.bAwaitingSectionChange = false;
+
+	// The cursor may have already followed the link or loop, in which case the clock is already where the montage is
+	const float ClockTime = Timeline.GetClockTime(World->GetTimeSeconds());
+	const int32 SectionIndex = Montage->GetSectionIndexFromPosition(Position);
+	if (bAwaitingSectionChange && SectionIndex == Timeline.SectionIndex && FMath::Abs(Position - ClockTime) <= GPlayMontageProSeekTolerance)
+	{
+		return;
+	}
+
+	// The montage ran off the end of the section before the clock did if it followed the section's link or looped, fire what it passed over rather than dropping it
+	// Anything else, e.g. Montage_JumpToSection, left the section early and drops the rest of it like the engine's notifies
+	// A cursor that already followed the link has dispatched the whole section, and the montage didn't follow it
+	const FAnimMontageInstance* MontageInstance = GetMontageInstance(Interface);
+	const bool bReachedSectionEnd = bLooped || (MontageInstance && MontageInstance->GetNextSectionID(Timeline.SectionIndex) == SectionIndex);
+	if (!bAwaitingSectionChange && Timeline.SectionIndex != INDEX_NONE && SectionIndex != INDEX_NONE && bReachedSectionEnd)
+	{
+		const uint32 Serial = Timeline.Serial;
+		const int32 SectionEndIndex = PlayMontagePro::FindFirstEventAfter(Timeline, Timeline.SectionEndTime);
+		for (int32 Index = Timeline.Cursor; Index < SectionEndIndex; Index++)
+		{
+			Interface->BroadcastNotifyEvent(Timeline.Notifies[Index], EAnimNotifyProTrigger::Scheduled);
+			if (Timeline.Serial != Serial)
+			{
+				return;
 			}
 		}
-		TimeDilation = NewTimeDilation;
 	}
+
+	SeekTimeline(Interface, World, Timeline, Position);
+}
+
+void UPlayMontageProStatics::SetMontagePosition(UAnimInstance* AnimInstance, const UAnimMontage* Montage, float NewPosition)
+{
+	if (!AnimInstance)
+	{
+		return;
+	}
+
+	AnimInstance->Montage_SetPosition(Montage, NewPosition);
+
+	const UWorld* World = AnimInstance->GetWorld();
+	PlayMontagePro::ForEachMontageTimeline(AnimInstance, Montage, [World](FAnimNotifyProTimeline& Timeline)
+	{
+		// Montage_SetPosition clamps the position, so read it back from the montage
+		IPlayMontageProInterface* Interface = Timeline.GetInterface();
+		if (const FAnimMontageInstance* MontageInstance = GetMontageInstance(Interface))
+		{
+			SeekTimeline(Interface, World, Timeline, MontageInstance->GetPosition());
+		}
+	});
+}
+
+void UPlayMontageProStatics::SetMontagePlayRate(UAnimInstance* AnimInstance, const UAnimMontage* Montage, float NewPlayRate)
+{
+	if (!AnimInstance)
+	{
+		return;
+	}
+
+	AnimInstance->Montage_SetPlayRate(Montage, NewPlayRate);
+
+	const UWorld* World = AnimInstance->GetWorld();
+	PlayMontagePro::ForEachMontageTimeline(AnimInstance, Montage, [World, NewPlayRate](FAnimNotifyProTimeline& Timeline)
+	{
+		SetTimelineRate(World, Timeline, NewPlayRate, Timeline.TimeDilation);
+	});
+}
+
+void UPlayMontageProStatics::PauseMontage(UAnimInstance* AnimInstance, const UAnimMontage* Montage)
+{
+	if (!AnimInstance)
+	{
+		return;
+	}
+
+	AnimInstance->Montage_Pause(Montage);
+
+	const UWorld* World = AnimInstance->GetWorld();
+	PlayMontagePro::ForEachMontageTimeline(AnimInstance, Montage, [World](FAnimNotifyProTimeline& Timeline)
+	{
+		SetTimelinePaused(World, Timeline, true);
+	});
+}
+
+void UPlayMontageProStatics::ResumeMontage(UAnimInstance* AnimInstance, const UAnimMontage* Montage)
+{
+	if (!AnimInstance)
+	{
+		return;
+	}
+
+	AnimInstance->Montage_Resume(Montage);
+
+	const UWorld* World = AnimInstance->GetWorld();
+	PlayMontagePro::ForEachMontageTimeline(AnimInstance, Montage, [World](FAnimNotifyProTimeline& Timeline)
+	{
+		SetTimelinePaused(World, Timeline, false);
+	});
+}
+
+void UPlayMontageProStatics::SetActorCustomTimeDilation(AActor* Actor, float NewTimeDilation)
+{
+	if (!Actor || FMath::IsNearlyEqual(Actor->CustomTimeDilation, NewTimeDilation))
+	{
+		return;
+	}
+
+	Actor->CustomTimeDilation = NewTimeDilation;
+
+	if (UPlayMontageProSubsystem* Subsystem = UPlayMontageProSubsystem::Get(Actor->GetWorld()))
+	{
+		Subsystem->NotifyTimeDilationChanged(Actor);
+	}
+}
+
+FAnimMontageInstance* UPlayMontageProStatics::GetMontageInstance(const IPlayMontageProInterface* Interface)
+{
+	const USkeletalMeshComponent* MeshComp = Interface ? Interface->GetMesh() : nullptr;
+	const UAnimInstance* AnimInstance = MeshComp ? MeshComp->GetAnimInstance() : nullptr;
+	return AnimInstance ? AnimInstance->GetActiveInstanceForMontage(Interface->GetMontage()) : nullptr;
 }
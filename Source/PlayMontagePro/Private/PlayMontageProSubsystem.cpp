@@ -0,0 +1,733 @@
+// Copyright (c) Jared Taylor
+
+#include "PlayMontageProSubsystem.h"
+
+#include "AnimNotifyPro.h"
+#include "AnimNotifyStatePro.h"
+#include "PlayMontagePro.h"
+#include "PlayMontageProCallbackProxy.h"
+#include "PlayMontageProStatics.h"
+#include "PlayMontageProTrace.h"
+#include "Animation/AnimMontage.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/ReferencerFinder.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(PlayMontageProSubsystem)
+
+static FAutoConsoleCommandWithWorld CVarPlayMontageProTimelinesDump(
+	TEXT("PlayMontagePro.Timelines.Dump"),
+	TEXT("Logs the number of active Pro notify timelines and armed timers in the world and how long the subsystem tick took"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UPlayMontageProSubsystem* Subsystem = UPlayMontageProSubsystem::Get(World))
+		{
+			UE_LOG(LogPlayMontagePro, Log, TEXT("Timelines: %d active, %d pooled, %d timers armed, last tick %.3fms"),
+				Subsystem->GetNumActiveTimelines(), Subsystem->GetTimelinePoolSize(), Subsystem->GetNumArmedTimers(), Subsystem->GetLastTickTimeMs());
+		}
+	}));
+
+static int32 GPlayMontageProProxyPoolMaxSize = 32;
+static FAutoConsoleVariableRef CVarPlayMontageProProxyPoolMaxSize(TEXT("PlayMontagePro.ProxyPool.MaxSize"), GPlayMontageProProxyPoolMaxSize, TEXT("Maximum number of Blueprint PlayMontagePro callback proxies kept per world for reuse once their montage has ended. 0 disables pooling"));
+
+static FAutoConsoleCommandWithWorld CVarPlayMontageProProxyPoolDump(
+	TEXT("PlayMontagePro.ProxyPool.Dump"),
+	TEXT("Logs the number of pooled PlayMontagePro callback proxies in the world, how often the pool was hit or missed and how many released proxies were still in use"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UPlayMontageProSubsystem* Subsystem = UPlayMontageProSubsystem::Get(World))
+		{
+			const int32 Requests = Subsystem->GetProxyPoolHits() + Subsystem->GetProxyPoolMisses();
+			UE_LOG(LogPlayMontagePro, Log, TEXT("ProxyPool: %d pooled (max %d), %d hits, %d misses (%.1f%% hit rate), %d rejected while still in use"),
+				Subsystem->GetProxyPoolSize(), GPlayMontageProProxyPoolMaxSize, Subsystem->GetProxyPoolHits(), Subsystem->GetProxyPoolMisses(),
+				Requests > 0 ? 100.f * Subsystem->GetProxyPoolHits() / Requests : 0.f, Subsystem->GetProxyPoolRejections());
+		}
+	}));
+
+static float GPlayMontageProDispatchBudgetMs = 0.f;
+static FAutoConsoleVariableRef CVarPlayMontageProDispatchBudgetMs(TEXT("PlayMontagePro.DispatchBudget.Ms"), GPlayMontageProDispatchBudgetMs, TEXT("Milliseconds per frame Pro notify callbacks may take before due notifies are deferred to a later frame. 0 disables the budget"));
+
+static FAutoConsoleCommandWithWorld CVarPlayMontageProDispatchBudgetDump(
+	TEXT("PlayMontagePro.DispatchBudget.Dump"),
+	TEXT("Logs how many Pro notifies the dispatch budget has deferred in the world and the latency it added"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UPlayMontageProSubsystem* Subsystem = UPlayMontageProSubsystem::Get(World))
+		{
+			UE_LOG(LogPlayMontagePro, Log, TEXT("DispatchBudget: %.2fms, %d deferred, %d waiting, %d dropped, %.2fms average latency, %.2fms max latency"),
+				GPlayMontageProDispatchBudgetMs, Subsystem->GetDeferredNotifyCount(), Subsystem->GetNumDeferredNotifies(),
+				Subsystem->GetDroppedDeferredNotifyCount(), Subsystem->GetAverageDeferredLatencyMs(), Subsystem->GetMaxDeferredLatencyMs());
+		}
+	}));
+
+FAnimNotifyProTimeline* FAnimNotifyProTimelineHandle::Get() const
+{
+	UPlayMontageProSubsystem* Owner = Subsystem.Get();
+	return Owner ? Owner->GetTimeline(*this) : nullptr;
+}
+
+UPlayMontageProSubsystem* UPlayMontageProSubsystem::Get(const UWorld* World)
+{
+	return World ? World->GetSubsystem<UPlayMontageProSubsystem>() : nullptr;
+}
+
+FAnimNotifyProTimeline* UPlayMontageProSubsystem::AcquireTimeline(const UWorld* World, UObject* Owner,
+	IPlayMontageProInterface* Interface, FAnimNotifyProTimelineHandle& OutHandle, AActor* TimeDilationActor, const UAnimMontage* Montage)
+{
+	ReleaseTimeline(OutHandle);
+
+	UPlayMontageProSubsystem* Subsystem = Get(World);
+	if (!Subsystem)
+	{
+		return nullptr;
+	}
+
+	int32 PoolIndex;
+	TArray<int32>& FreeIndices = Subsystem->FreeIndices;
+	if (FreeIndices.Num() > 0)
+	{
+		// Prefer a slot that last played the montage, its events are reused as they are unless GatherNotifies finds the schedule was rebuilt
+		int32 FreeSlot = FreeIndices.Num() - 1;
+		if (Montage && FreeIndices.Num() > 1)
+		{
+			const TObjectKey<UAnimMontage> MontageKey(Montage);
+			for (int32 Slot = FreeIndices.Num() - 1; Slot >= 0; Slot--)
+			{
+				if (Subsystem->Timelines[FreeIndices[Slot]].GatheredMontage == MontageKey)
+				{
+					FreeSlot = Slot;
+					break;
+				}
+			}
+		}
+		FreeIndices.Swap(FreeSlot, FreeIndices.Num() - 1);
+		PoolIndex = FreeIndices.Pop(EAllowShrinking::No);
+	}
+	else
+	{
+		// New slots bind their cursor delegate once, it is reused by every timeline that occupies the slot
+		PoolIndex = Subsystem->Timelines.Add(1);
+		FAnimNotifyProTimeline& NewTimeline = Subsystem->Timelines[PoolIndex];
+		NewTimeline.PoolIndex = PoolIndex;
+		NewTimeline.CursorTimerDelegate = FTimerDelegate::CreateUObject(Subsystem, &ThisClass::OnCursorTimer, PoolIndex);
+	}
+
+	FAnimNotifyProTimeline& Timeline = Subsystem->Timelines[PoolIndex];
+	Timeline.bActive = true;
+	Timeline.Owner = Owner;
+	Timeline.Interface = Interface;
+	Subsystem->NumActiveTimelines++;
+	INC_DWORD_STAT(STAT_PlayMontagePro_ActiveTimelines);
+	CSV_CUSTOM_STAT(PlayMontagePro, ActiveTimelines, Subsystem->NumActiveTimelines, ECsvCustomStatOp::Set);
+
+	if (TimeDilationActor)
+	{
+		Timeline.TimeDilation = TimeDilationActor->CustomTimeDilation;
+		Timeline.TimeDilationActor = TimeDilationActor;
+		Subsystem->TimeDilationFollowers.FindOrAdd(TimeDilationActor).Add(PoolIndex);
+	}
+
+	if (USkeletalMeshComponent* Mesh = Interface ? Interface->GetMesh() : nullptr)
+	{
+		Timeline.Mesh = Mesh;
+		Subsystem->MeshTimelines.FindOrAdd(Mesh).Add(PoolIndex);
+	}
+
+	OutHandle.Subsystem = Subsystem;
+	OutHandle.Index = PoolIndex;
+	OutHandle.Generation = Timeline.Generation;
+	return &Timeline;
+}
+
+void UPlayMontageProSubsystem::ReleaseTimeline(FAnimNotifyProTimelineHandle& Handle)
+{
+	if (UPlayMontageProSubsystem* Subsystem = Handle.Subsystem.Get())
+	{
+		if (FAnimNotifyProTimeline* Timeline = Subsystem->GetTimeline(Handle))
+		{
+			Subsystem->FreeTimeline(*Timeline);
+		}
+	}
+	Handle = FAnimNotifyProTimelineHandle();
+}
+
+FAnimNotifyProTimeline* UPlayMontageProSubsystem::GetTimeline(const FAnimNotifyProTimelineHandle& Handle)
+{
+	if (Handle.Index < 0 || Handle.Index >= Timelines.Num())
+	{
+		return nullptr;
+	}
+
+	FAnimNotifyProTimeline& Timeline = Timelines[Handle.Index];
+	return Timeline.bActive && Timeline.Generation == Handle.Generation ? &Timeline : nullptr;
+}
+
+FAnimNotifyProEvent* UPlayMontageProSubsystem::GetEvent(const FAnimNotifyProEventHandle& Handle)
+{
+	if (Handle.TimelineIndex < 0 || Handle.TimelineIndex >= Timelines.Num())
+	{
+		return nullptr;
+	}
+
+	FAnimNotifyProTimeline& Timeline = Timelines[Handle.TimelineIndex];
+	if (!Timeline.bActive || Timeline.Generation != Handle.Generation || Timeline.EventGeneration != Handle.EventGeneration
+		|| !Timeline.Notifies.IsValidIndex(Handle.EventIndex))
+	{
+		return nullptr;
+	}
+	return &Timeline.Notifies[Handle.EventIndex];
+}
+
+FTimerDelegate UPlayMontageProSubsystem::CreateNotifyTimerDelegate(const FAnimNotifyProTimeline& Timeline, int32 EventIndex)
+{
+	FAnimNotifyProEventHandle Handle;
+	Handle.TimelineIndex = Timeline.PoolIndex;
+	Handle.EventIndex = EventIndex;
+	Handle.EventGeneration = Timeline.EventGeneration;
+	Handle.Generation = Timeline.Generation;
+	return FTimerDelegate::CreateUObject(this, &ThisClass::OnNotifyTimer, Handle);
+}
+
+void UPlayMontageProSubsystem::ForEachActiveTimeline(TFunctionRef<void(FAnimNotifyProTimeline&)> Function)
+{
+	for (int32 PoolIndex = 0; PoolIndex < Timelines.Num(); PoolIndex++)
+	{
+		if (Timelines[PoolIndex].bActive)
+		{
+			Function(Timelines[PoolIndex]);
+		}
+	}
+}
+
+void UPlayMontageProSubsystem::ForEachMeshTimeline(const USkeletalMeshComponent* Mesh, TFunctionRef<void(FAnimNotifyProTimeline&)> Function)
+{
+	const TArray<int32, TInlineAllocator<2>>* MeshIndices = MeshTimelines.Find(Mesh);
+	if (!MeshIndices)
+	{
+		return;
+	}
+
+	// The function may end a montage and release its timeline, which changes the mesh's list
+	const TArray<int32, TInlineAllocator<8>> PoolIndices(*MeshIndices);
+	const TObjectKey<USkeletalMeshComponent> MeshKey(Mesh);
+	for (const int32 PoolIndex : PoolIndices)
+	{
+		FAnimNotifyProTimeline& Timeline = Timelines[PoolIndex];
+		if (Timeline.bActive && Timeline.Mesh == MeshKey)
+		{
+			Function(Timeline);
+		}
+	}
+}
+
+void UPlayMontageProSubsystem::NotifyTimeDilationChanged(AActor* Actor)
+{
+	if (!Actor)
+	{
+		return;
+	}
+
+	// Notify times are in montage time, so each follower only rebases its clock
+	const float TimeDilation = Actor->CustomTimeDilation;
+	if (const TArray<int32, TInlineAllocator<2>>* Followers = TimeDilationFollowers.Find(Actor))
+	{
+		for (const int32 PoolIndex : *Followers)
+		{
+			FAnimNotifyProTimeline& Timeline = Timelines[PoolIndex];
+			UPlayMontageProStatics::SetTimelineRate(GetWorld(), Timeline, Timeline.PlayRate, TimeDilation);
+		}
+	}
+
+	OnTimeDilationChanged.Broadcast(Actor, TimeDilation);
+}
+
+UPlayMontageProCallbackProxy* UPlayMontageProSubsystem::AcquireProxy(const UWorld* World)
+{
+	UPlayMontageProSubsystem* Subsystem = Get(World);
+	if (Subsystem && Subsystem->FreeProxies.Num() > 0)
+	{
+		Subsystem->ProxyPoolHits++;
+		return Subsystem->FreeProxies.Pop(EAllowShrinking::No);
+	}
+
+	if (Subsystem)
+	{
+		Subsystem->ProxyPoolMisses++;
+	}
+	return NewObject<UPlayMontageProCallbackProxy>();
+}
+
+void UPlayMontageProSubsystem::ReleaseProxy(UPlayMontageProCallbackProxy* Proxy)
+{
+	if (!Proxy || FreeProxies.Num() + PendingProxies.Num() >= GPlayMontageProProxyPoolMaxSize)
+	{
+		return;
+	}
+
+	// Whatever ended the montage may still be using the proxy this frame, so it is only reset and pooled by a later tick
+	PendingProxies.Push(Proxy);
+	PendingProxiesFrame = GFrameCounter;
+}
+
+void UPlayMontageProSubsystem::PoolPendingProxies()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProSubsystem::PoolPendingProxies);
+
+	// A Blueprint still bound to a proxy would receive events for whichever montage reuses it
+	TArray<UObject*> Candidates;
+	for (UPlayMontageProCallbackProxy* Proxy : PendingProxies)
+	{
+		if (Proxy->HasLiveListeners())
+		{
+			ProxyPoolRejections++;
+		}
+		else
+		{
+			Candidates.Add(Proxy);
+		}
+	}
+	PendingProxies.Reset();
+
+	if (Candidates.Num() == 0)
+	{
+		return;
+	}
+
+	// Nor can one be reused while a Blueprint variable or the node's frame still holds it. The search walks every object, so the
+	// candidates are checked together and all are left for GC if any of them is still referenced
+	const TSet<UObject*> IgnoredReferencers = { this };
+	if (FReferencerFinder::GetAllReferencers(Candidates, &IgnoredReferencers, EReferencerFinderFlags::SkipInnerReferences).Num() > 0)
+	{
+		ProxyPoolRejections += Candidates.Num();
+		return;
+	}
+
+	for (UObject* Candidate : Candidates)
+	{
+		UPlayMontageProCallbackProxy* Proxy = CastChecked<UPlayMontageProCallbackProxy>(Candidate);
+		Proxy->ResetForPool();
+		FreeProxies.Push(Proxy);
+	}
+}
+
+void UPlayMontageProSubsystem::OpenTickWindow(const FAnimNotifyProTimeline& Timeline, int32 BeginIndex)
+{
+	const FAnimNotifyProScheduleEntry& Entry = Timeline.GetEntry(BeginIndex);
+	if (!Entry.NotifyState || !Entry.NotifyState->WantsProTick())
+	{
+		return;
+	}
+
+	// Seeking back may replay the begin event before the window it opened last time has been removed
+	for (const FAnimNotifyProTickWindow& Window : TickWindows)
+	{
+		if (Window.PoolIndex == Timeline.PoolIndex && Window.Generation == Timeline.Generation && Window.BeginIndex == BeginIndex)
+		{
+			return;
+		}
+	}
+
+	FAnimNotifyProTickWindow& Window = TickWindows.AddDefaulted_GetRef();
+	Window.NotifyState = Entry.NotifyState;
+	Window.PoolIndex = Timeline.PoolIndex;
+	Window.Generation = Timeline.Generation;
+	Window.BeginIndex = BeginIndex;
+	Window.EndIndex = Entry.PairIndex;
+	Window.OpenedFrame = GFrameCounter;
+}
+
+bool UPlayMontageProSubsystem::HasDispatchBudget()
+{
+	return GPlayMontageProDispatchBudgetMs > 0.f;
+}
+
+bool UPlayMontageProSubsystem::IsOverDispatchBudget()
+{
+	if (DispatchBudgetFrame != GFrameCounter)
+	{
+		DispatchBudgetFrame = GFrameCounter;
+		DispatchBudgetSpent = 0.0;
+	}
+	return HasDispatchBudget() && DispatchBudgetSpent * 1000.0 >= GPlayMontageProDispatchBudgetMs;
+}
+
+void UPlayMontageProSubsystem::AddDispatchTime(double Seconds)
+{
+	if (DispatchBudgetFrame != GFrameCounter)
+	{
+		DispatchBudgetFrame = GFrameCounter;
+		DispatchBudgetSpent = 0.0;
+	}
+	DispatchBudgetSpent += Seconds;
+}
+
+bool UPlayMontageProSubsystem::TryDeferNotify(FAnimNotifyProTimeline& Timeline, int32 EventIndex)
+{
+	if (!IsOverDispatchBudget())
+	{
+		return false;
+	}
+
+	const FAnimNotifyProScheduleEntry& Entry = Timeline.GetEntry(EventIndex);
+	if (Entry.EnsureTriggerNotify != 0 || Entry.bCritical)
+	{
+		return false;
+	}
+
+	// The event stays out of dispatch until it is drained, or forgotten if a seek replays it
+	Timeline.Notifies[EventIndex].bDeferred = true;
+	DeferredNotifies.HeapPush({ Timeline.PoolIndex, Timeline.Generation, EventIndex, GetWorld()->GetTimeSeconds() });
+	DeferredNotifyCount++;
+	return true;
+}
+
+void UPlayMontageProSubsystem::AddArmedTimers(int32 Delta)
+{
+	NumArmedTimers += Delta;
+	if (Delta > 0)
+	{
+		INC_DWORD_STAT_BY(STAT_PlayMontagePro_TimersArmed, Delta);
+	}
+	else
+	{
+		DEC_DWORD_STAT_BY(STAT_PlayMontagePro_TimersArmed, -Delta);
+	}
+	CSV_CUSTOM_STAT(PlayMontagePro, TimersArmed, NumArmedTimers, ECsvCustomStatOp::Set);
+}
+
+void UPlayMontageProSubsystem::ScheduleTimeline(FAnimNotifyProTimeline& Timeline, double DueTime)
+{
+	// The previous entry, if any, is left in the heap and skipped when popped because its due time no longer matches
+	Timeline.NextDueTime = DueTime;
+	DueTimelines.HeapPush({ DueTime, Timeline.PoolIndex, Timeline.Generation });
+
+	// Each active timeline has at most one live entry, past twice that most of the heap is stale, e.g. from timelines retimed every frame
+	if (DueTimelines.Num() > FMath::Max(NumActiveTimelines * 2, 16))
+	{
+		CompactDueTimelines();
+	}
+}
+
+bool UPlayMontageProSubsystem::IsDueTimelineLive(const FAnimNotifyProDueTimeline& Due) const
+{
+	const FAnimNotifyProTimeline& Timeline = Timelines[Due.PoolIndex];
+	return Timeline.bActive && Timeline.Generation == Due.Generation && Timeline.NextDueTime == Due.DueTime;
+}
+
+void UPlayMontageProSubsystem::CompactDueTimelines()
+{
+	// Keeps the allocation, the heap grows back to the same size
+	DueTimelines.RemoveAllSwap([this](const FAnimNotifyProDueTimeline& Due) { return !IsDueTimelineLive(Due); }, EAllowShrinking::No);
+	DueTimelines.Heapify();
+}
+
+void UPlayMontageProSubsystem::Deinitialize()
+{
+	for (int32 PoolIndex = 0; PoolIndex < Timelines.Num(); PoolIndex++)
+	{
+		if (Timelines[PoolIndex].bActive)
+		{
+			FreeTimeline(Timelines[PoolIndex]);
+		}
+	}
+	// Timers forgotten by their event without being cleared die with the world's timer manager
+	AddArmedTimers(-NumArmedTimers);
+
+	Timelines.Empty();
+	FreeIndices.Empty();
+	TimeDilationFollowers.Empty();
+	MeshTimelines.Empty();
+	DueTimelines.Empty();
+	TickWindows.Empty();
+	DeferredNotifies.Empty();
+	FreeProxies.Empty();
+	PendingProxies.Empty();
+
+	Super::Deinitialize();
+}
+
+void UPlayMontageProSubsystem::Tick(float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProSubsystem::Tick);
+
+	const double TickStartTime = FPlatformTime::Seconds();
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+
+	// Proxies released in an earlier frame are no longer in use by the callbacks that ended their montage
+	if (PendingProxies.Num() > 0 && PendingProxiesFrame < GFrameCounter)
+	{
+		PoolPendingProxies();
+	}
+
+	// Deferred notifies have waited at least a frame, they come before anything that is due now
+	if (DeferredNotifies.Num() > 0)
+	{
+		DrainDeferredNotifies();
+	}
+
+	// Notify states tick before the due events, so a state ending this frame has its last tick first
+	if (TickWindows.Num() > 0)
+	{
+		TickNotifyStates(DeltaTime);
+	}
+
+	// Dispatching re-schedules the timeline for its next event, which is always later than now
+	while (DueTimelines.Num() > 0 && DueTimelines.HeapTop().DueTime <= WorldTime)
+	{
+		FAnimNotifyProDueTimeline Due;
+		DueTimelines.HeapPop(Due, EAllowShrinking::No);
+
+		if (!IsDueTimelineLive(Due))
+		{
+			continue;
+		}
+
+		FAnimNotifyProTimeline& Timeline = Timelines[Due.PoolIndex];
+		Timeline.NextDueTime = -1.0;
+		DispatchTimeline(Timeline);
+	}
+
+	LastTickTimeMs = static_cast<float>((FPlatformTime::Seconds() - TickStartTime) * 1000.0);
+}
+
+TStatId UPlayMontageProSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPlayMontageProSubsystem, STATGROUP_PlayMontagePro);
+}
+
+void UPlayMontageProSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	UPlayMontageProSubsystem* This = CastChecked<UPlayMontageProSubsystem>(InThis);
+	for (int32 PoolIndex = 0; PoolIndex < This->Timelines.Num(); PoolIndex++)
+	{
+		// Events resolve their notifies through the schedule, which are instanced within the montage
+		FAnimNotifyProTimeline& Timeline = This->Timelines[PoolIndex];
+		if (Timeline.bActive)
+		{
+			Collector.AddReferencedObject(Timeline.Montage, This);
+		}
+	}
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+void UPlayMontageProSubsystem::OnCursorTimer(int32 PoolIndex)
+{
+	// Fired timers are no longer armed, even if their timeline has since been released
+	AddArmedTimers(-1);
+
+	if (PoolIndex < Timelines.Num() && Timelines[PoolIndex].bActive)
+	{
+		// The timer manager still reports the fired timer while it executes, forget it so re-arming it counts again
+		FAnimNotifyProTimeline& Timeline = Timelines[PoolIndex];
+		Timeline.CursorTimer.Invalidate();
+		DispatchTimeline(Timeline);
+	}
+}
+
+void UPlayMontageProSubsystem::OnNotifyTimer(FAnimNotifyProEventHandle Handle)
+{
+	AddArmedTimers(-1);
+
+	// A timer that outlived the events it was armed for no longer resolves
+	FAnimNotifyProEvent* Event = GetEvent(Handle);
+	if (!Event)
+	{
+		return;
+	}
+
+	// The timer manager still reports the fired timer while it executes, forget it so it isn't cleared and uncounted a second time
+	Event->Timer.Invalidate();
+
+	FAnimNotifyProTimeline& Timeline = Timelines[Handle.TimelineIndex];
+	if (IPlayMontageProInterface* Interface = Timeline.GetInterface())
+	{
+		UPlayMontageProStatics::DispatchDueTimerNotifies(Interface, GetWorld(), Timeline, Handle.EventIndex);
+	}
+	else
+	{
+		FreeTimeline(Timeline);
+	}
+}
+
+void UPlayMontageProSubsystem::DispatchTimeline(FAnimNotifyProTimeline& Timeline)
+{
+	if (IPlayMontageProInterface* Interface = Timeline.GetInterface())
+	{
+		UPlayMontageProStatics::DispatchDueNotifies(Interface, GetWorld(), Timeline);
+	}
+	else
+	{
+		// The owner was destroyed without releasing its timeline
+		FreeTimeline(Timeline);
+	}
+}
+
+void UPlayMontageProSubsystem::TickNotifyStates(float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProSubsystem::TickNotifyStates);
+
+	// Iterate backwards so closed windows can be swapped out, windows opened by a callback are appended and skipped until next frame
+	for (int32 WindowIndex = TickWindows.Num() - 1; WindowIndex >= 0; WindowIndex--)
+	{
+		FAnimNotifyProTickWindow& Window = TickWindows[WindowIndex];
+		if (Window.OpenedFrame == GFrameCounter)
+		{
+			continue;
+		}
+
+		FAnimNotifyProTimeline& Timeline = Timelines[Window.PoolIndex];
+		const bool bOpen = Timeline.bActive && Timeline.Generation == Window.Generation
+			&& Timeline.Notifies.IsValidIndex(Window.BeginIndex) && Timeline.Notifies[Window.BeginIndex].bHasBroadcast
+			&& Timeline.Notifies.IsValidIndex(Window.EndIndex) && !Timeline.Notifies[Window.EndIndex].bHasBroadcast;
+		IPlayMontageProInterface* Interface = bOpen ? Timeline.GetInterface() : nullptr;
+		if (!Interface)
+		{
+			TickWindows.RemoveAtSwap(WindowIndex, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		// Montage time, so the tick follows the play rate and time dilation and doesn't advance while paused
+		Window.Elapsed += DeltaTime * Timeline.GetClockRate();
+		Window.Frames++;
+
+		bool bDue = false;
+		switch (Window.NotifyState->TickInterval)
+		{
+		case EAnimNotifyProTickInterval::EveryFrame:
+			bDue = !Timeline.bPaused;
+			break;
+		case EAnimNotifyProTickInterval::FixedRate:
+			bDue = Window.Elapsed * FMath::Max(Window.NotifyState->TickRate, UE_KINDA_SMALL_NUMBER) >= 1.f;
+			break;
+		case EAnimNotifyProTickInterval::EveryNFrames:
+			bDue = !Timeline.bPaused && Window.Frames >= Window.NotifyState->TickFrames;
+			break;
+		default:
+			break;
+		}
+
+		if (bDue)
+		{
+			// The callback may open or close windows, so nothing is read from the window after it
+			const float Elapsed = Window.Elapsed;
+			Window.Elapsed = 0.f;
+			Window.Frames = 0;
+			Window.NotifyState->NotifyTickCallback(Interface->GetMesh(), Interface->GetMontage(), Elapsed);
+		}
+	}
+}
+
+void UPlayMontageProSubsystem::DrainDeferredNotifies()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPlayMontageProSubsystem::DrainDeferredNotifies);
+	PLAYMONTAGEPRO_SCOPE_TIME(Dispatch);
+
+	// Timers may have spent the budget before the tick, at least one notify is drained each frame so the queue can't starve
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	bool bDrainedAny = false;
+	while (DeferredNotifies.Num() > 0 && (!bDrainedAny || !IsOverDispatchBudget()))
+	{
+		FAnimNotifyProDeferredNotify Deferred;
+		DeferredNotifies.HeapPop(Deferred, EAllowShrinking::No);
+
+		// Entries are ordered by when they were deferred alone, so once the top was deferred this frame so was everything left
+		// They all wait for the next frame, skipping them one by one would only pop and push the whole heap
+		if (Deferred.DeferredTime >= WorldTime)
+		{
+			DeferredNotifies.HeapPush(Deferred);
+			break;
+		}
+
+		FAnimNotifyProTimeline& Timeline = Timelines[Deferred.PoolIndex];
+		if (!Timeline.bActive || Timeline.Generation != Deferred.Generation || !Timeline.Notifies.IsValidIndex(Deferred.EventIndex)
+			|| !Timeline.Notifies[Deferred.EventIndex].bDeferred)
+		{
+			continue;
+		}
+
+		IPlayMontageProInterface* Interface = Timeline.GetInterface();
+		if (!Interface)
+		{
+			continue;
+		}
+
+		const double Latency = WorldTime - Deferred.DeferredTime;
+		DeferredLatencySeconds += Latency;
+		MaxDeferredLatencySeconds = FMath::Max(MaxDeferredLatencySeconds, Latency);
+		DrainedNotifyCount++;
+		bDrainedAny = true;
+
+		FAnimNotifyProEvent& Event = Timeline.Notifies[Deferred.EventIndex];
+		Event.bDeferred = false;
+
+		const double StartTime = FPlatformTime::Seconds();
+		UPlayMontageProStatics::BroadcastNotifyEvent(Timeline, Event, Interface);
+		AddDispatchTime(FPlatformTime::Seconds() - StartTime);
+	}
+}
+
+void UPlayMontageProSubsystem::FreeTimeline(FAnimNotifyProTimeline& Timeline)
+{
+	// Events still waiting on the dispatch budget never fire, their entries in the queue no longer resolve
+	if (DeferredNotifies.Num() > 0)
+	{
+		for (int32 Index = 0; Index < Timeline.Notifies.Num(); Index++)
+		{
+			FAnimNotifyProEvent& Event = Timeline.Notifies[Index];
+			if (Event.bDeferred)
+			{
+				Event.bDeferred = false;
+				Event.bNotifySkipped = true;
+				DroppedDeferredNotifyCount++;
+				PLAYMONTAGEPRO_COUNT(EventsSkipped, 1);
+				TRACE_PLAYMONTAGEPRO_NOTIFY(Skipped, Timeline, Index, 1);
+			}
+		}
+	}
+
+	TRACE_PLAYMONTAGEPRO_CANCELLED(Timeline);
+	UPlayMontageProStatics::ClearNotifyTimers(GetWorld(), Timeline);
+
+	if (TArray<int32, TInlineAllocator<2>>* Followers = TimeDilationFollowers.Find(Timeline.TimeDilationActor))
+	{
+		Followers->RemoveSingleSwap(Timeline.PoolIndex);
+		if (Followers->Num() == 0)
+		{
+			TimeDilationFollowers.Remove(Timeline.TimeDilationActor);
+		}
+	}
+	Timeline.TimeDilationActor = nullptr;
+
+	if (TArray<int32, TInlineAllocator<2>>* MeshIndices = MeshTimelines.Find(Timeline.Mesh))
+	{
+		MeshIndices->RemoveSingleSwap(Timeline.PoolIndex);
+		if (MeshIndices->Num() == 0)
+		{
+			MeshTimelines.Remove(Timeline.Mesh);
+		}
+	}
+	Timeline.Mesh = nullptr;
+
+	// Keep the events, the next timeline to play the same montage in this slot reuses them rather than gathering again
+	Timeline.SectionIndex = INDEX_NONE;
+	Timeline.SectionBegin = 0;
+	Timeline.SectionEnd = 0;
+	Timeline.bAwaitingSectionChange = false;
+	Timeline.Montage = nullptr;
+	Timeline.Owner.Reset();
+	Timeline.Interface = nullptr;
+	Timeline.PlayRate = 1.f;
+	Timeline.TimeDilation = 1.f;
+	Timeline.bPaused = false;
+	Timeline.Cursor = 0;
+	Timeline.bActive = false;
+	Timeline.Generation++;
+
+	FreeIndices.Push(Timeline.PoolIndex);
+	NumActiveTimelines--;
+	DEC_DWORD_STAT(STAT_PlayMontagePro_ActiveTimelines);
+	CSV_CUSTOM_STAT(PlayMontagePro, ActiveTimelines, NumActiveTimelines, ECsvCustomStatOp::Set);
+}
@@ -0,0 +1,151 @@
+// Copyright (c) Jared Taylor
+
+#include "PlayMontageProTrace.h"
+
+#if PLAYMONTAGEPRO_TRACE_ENABLED
+
+#include "ObjectTrace.h"
+#include "PlayMontageProInterface.h"
+#include "PlayMontageTypes.h"
+#include "Animation/AnimMontage.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Trace/Trace.inl"
+
+UE_TRACE_CHANNEL_DEFINE(PlayMontageProChannel);
+
+UE_TRACE_EVENT_BEGIN(PlayMontagePro, ScheduleBuilt)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, MontageId)
+	UE_TRACE_EVENT_FIELD(uint32, NumEntries)
+	UE_TRACE_EVENT_FIELD(bool, bBaked)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, MontageName)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(PlayMontagePro, NotifyEvent)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, MontageId)
+	UE_TRACE_EVENT_FIELD(uint64, OwnerId)
+	UE_TRACE_EVENT_FIELD(uint32, NotifyId)
+	UE_TRACE_EVENT_FIELD(float, ScheduledTime)
+	UE_TRACE_EVENT_FIELD(float, ActualTime)
+	UE_TRACE_EVENT_FIELD(double, WorldTime)
+	UE_TRACE_EVENT_FIELD(uint8, Type)
+	UE_TRACE_EVENT_FIELD(uint8, Reason)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(PlayMontagePro, TimelineRetimed)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, MontageId)
+	UE_TRACE_EVENT_FIELD(uint64, OwnerId)
+	UE_TRACE_EVENT_FIELD(float, ClockTime)
+	UE_TRACE_EVENT_FIELD(float, OldRate)
+	UE_TRACE_EVENT_FIELD(float, NewRate)
+	UE_TRACE_EVENT_FIELD(double, WorldTime)
+	UE_TRACE_EVENT_FIELD(uint8, Reason)
+UE_TRACE_EVENT_END()
+
+namespace PlayMontageProTrace
+{
+	static uint64 GetObjectId(const UObject* Object)
+	{
+#if OBJECT_TRACE_ENABLED
+		return Object ? FObjectTrace::GetObjectId(Object) : 0;
+#else
+		return static_cast<uint64>(reinterpret_cast<UPTRINT>(Object));
+#endif
+	}
+
+	/** @return The actor playing the timeline's montage, or nullptr once its node is gone */
+	static const AActor* GetOwningActor(const FAnimNotifyProTimeline& Timeline)
+	{
+		const IPlayMontageProInterface* Interface = Timeline.GetInterface();
+		const USkeletalMeshComponent* MeshComp = Interface ? Interface->GetMesh() : nullptr;
+		return MeshComp ? MeshComp->GetOwner() : nullptr;
+	}
+
+	/** @return The world time now, or the clock's last rebase if the timeline's world can't be reached */
+	static double GetWorldTime(const FAnimNotifyProTimeline& Timeline)
+	{
+		const AActor* Actor = GetOwningActor(Timeline);
+		const UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+		return World ? World->GetTimeSeconds() : Timeline.ClockWorldTime;
+	}
+}
+
+void FPlayMontageProTrace::OutputScheduleBuilt(const UAnimMontage* Montage, const FAnimNotifyProSchedule& Schedule, bool bBaked)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(PlayMontageProChannel) || !Montage)
+	{
+		return;
+	}
+
+	const FString MontageName = Montage->GetPathName();
+	UE_TRACE_LOG(PlayMontagePro, ScheduleBuilt, PlayMontageProChannel)
+		<< ScheduleBuilt.Cycle(FPlatformTime::Cycles64())
+		<< ScheduleBuilt.MontageId(PlayMontageProTrace::GetObjectId(Montage))
+		<< ScheduleBuilt.NumEntries(Schedule.Entries.Num())
+		<< ScheduleBuilt.bBaked(bBaked)
+		<< ScheduleBuilt.MontageName(*MontageName, MontageName.Len());
+}
+
+void FPlayMontageProTrace::OutputNotifyEvent(EPlayMontageProTraceEvent Type, const FAnimNotifyProTimeline& Timeline, int32 EventIndex, uint8 Reason)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(PlayMontageProChannel) || !Timeline.Notifies.IsValidIndex(EventIndex))
+	{
+		return;
+	}
+
+	const FAnimNotifyProEvent& Event = Timeline.Notifies[EventIndex];
+	const double WorldTime = PlayMontageProTrace::GetWorldTime(Timeline);
+	UE_TRACE_LOG(PlayMontagePro, NotifyEvent, PlayMontageProChannel)
+		<< NotifyEvent.Cycle(FPlatformTime::Cycles64())
+		<< NotifyEvent.MontageId(PlayMontageProTrace::GetObjectId(Timeline.Montage))
+		<< NotifyEvent.OwnerId(PlayMontageProTrace::GetObjectId(PlayMontageProTrace::GetOwningActor(Timeline)))
+		<< NotifyEvent.NotifyId(Event.NotifyId)
+		<< NotifyEvent.ScheduledTime(Event.Time)
+		<< NotifyEvent.ActualTime(Timeline.GetClockTime(WorldTime))
+		<< NotifyEvent.WorldTime(WorldTime)
+		<< NotifyEvent.Type(static_cast<uint8>(Type))
+		<< NotifyEvent.Reason(Reason);
+}
+
+void FPlayMontageProTrace::OutputRetimed(EPlayMontageProTraceRetime Reason, const FAnimNotifyProTimeline& Timeline, float OldRate)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(PlayMontageProChannel))
+	{
+		return;
+	}
+
+	const double WorldTime = PlayMontageProTrace::GetWorldTime(Timeline);
+	UE_TRACE_LOG(PlayMontagePro, TimelineRetimed, PlayMontageProChannel)
+		<< TimelineRetimed.Cycle(FPlatformTime::Cycles64())
+		<< TimelineRetimed.MontageId(PlayMontageProTrace::GetObjectId(Timeline.Montage))
+		<< TimelineRetimed.OwnerId(PlayMontageProTrace::GetObjectId(PlayMontageProTrace::GetOwningActor(Timeline)))
+		<< TimelineRetimed.ClockTime(Timeline.GetClockTime(WorldTime))
+		<< TimelineRetimed.OldRate(OldRate)
+		<< TimelineRetimed.NewRate(Timeline.GetClockRate())
+		<< TimelineRetimed.WorldTime(WorldTime)
+		<< TimelineRetimed.Reason(static_cast<uint8>(Reason));
+}
+
+void FPlayMontageProTrace::OutputCancelled(const FAnimNotifyProTimeline& Timeline)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(PlayMontageProChannel))
+	{
+		return;
+	}
+
+	// Deferred events have already been traced as skipped by the subsystem
+	for (int32 Index = Timeline.SectionBegin; Index < Timeline.SectionEnd; Index++)
+	{
+		const FAnimNotifyProEvent& Event = Timeline.Notifies[Index];
+		if (!Event.bHasBroadcast && !Event.bNotifySkipped && !Event.bFiltered)
+		{
+			OutputNotifyEvent(EPlayMontageProTraceEvent::Cancelled, Timeline, Index, 0);
+		}
+	}
+}
+
+#endif
@@ -2,9 +2,6 @@
 
 #include "PlayMontageTypes.h"
 
-#include "AnimNotifyPro.h"
-#include "AnimNotifyStatePro.h"
-
 #include UE_INLINE_GENERATED_CPP_BY_NAME(PlayMontageTypes)
 
 void FAnimNotifyProEvent::ClearTimers()
@@ -14,21 +11,4 @@ void FAnimNotifyProEvent::ClearTimers()
 	{
 		Timer.Invalidate();
 	}
-
-	// We will crash if we attempt to unbind a delegate connected to a null object
-	if (!TaskOwner.IsValid())
-	{
-		return;
-	}
-	
-	// Unbind the delegate if bound
-	if (TimerDelegate.IsBound())
-	{
-		TimerDelegate.Unbind();
-	}
-}
-
-bool FAnimNotifyProEvent::IsValidEvent() const
-{
-	return NotifyId > 0 && TaskOwner.IsValid() && (Notify != nullptr || NotifyState != nullptr);
 }
@@ -0,0 +1,110 @@
+// Copyright (c) Jared Taylor
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PlayMontageProStatics.h"
+#include "PlayMontageProTestHelpers.h"
+#include "PlayMontageProTestTypes.h"
+#include "Animation/AnimMontage.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "TimerManager.h"
+
+using namespace PlayMontagePro::Tests;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayMontageProAllocationTest, "PlayMontagePro.Timelines.Allocations",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FPlayMontageProAllocationTest::RunTest(const FString& Parameters)
+{
+	FScopedTestWorld TestWorld;
+	UWorld* World = TestWorld.Get();
+	if (!TestNotNull(TEXT("Subsystem"), TestWorld.GetSubsystem()))
+	{
+		return false;
+	}
+
+	// 16 events fit the timeline's inline storage, the second section is jumped to mid-play
+	UAnimMontage* Montage = CreateMontage(4.f, 2, 8, 4);
+	const float SecondSectionTime = Montage->CompositeSections[1].GetTime();
+	AActor* TimeDilationActor = World->SpawnActor<AActor>();
+	UPlayMontageProTestPlayer* Player = NewObject<UPlayMontageProTestPlayer>();
+	UPlayMontageProTestPlayer* Calibrator = NewObject<UPlayMontageProTestPlayer>();
+	FTimerManager& TimerManager = World->GetTimerManager();
+
+	FScopedAllocationCounter Allocations;
+	if (!Allocations.IsCounting())
+	{
+		AddWarning(TEXT("Allocations don't go through GMalloc on this platform, nothing to count"));
+		return true;
+	}
+
+	// What FTimerManager allocates arming that many timers for an object that has none, which the timer modes can't avoid
+	auto CountTimerManagerAllocations = [&](int32 NumTimers)
+	{
+		TArray<FTimerHandle, TInlineAllocator<32>> Handles;
+		Handles.SetNum(NumTimers);
+		Allocations.Reset();
+		for (FTimerHandle& Handle : Handles)
+		{
+			TimerManager.SetTimer(Handle, FTimerDelegate::CreateUObject(Calibrator, &UPlayMontageProTestPlayer::OnTestTimer, FAnimNotifyProEventHandle()), 1.f, false);
+		}
+		const int32 NumAllocations = Allocations.GetNum();
+		for (FTimerHandle& Handle : Handles)
+		{
+			TimerManager.ClearTimer(Handle);
+		}
+		return NumAllocations;
+	};
+
+	static const TCHAR* ModeNames[] = { TEXT("Timers"), TEXT("Cursor"), TEXT("Tick") };
+	for (const EAnimNotifyProScheduleMode Mode : { EAnimNotifyProScheduleMode::Timers, EAnimNotifyProScheduleMode::Cursor, EAnimNotifyProScheduleMode::Tick })
+	{
+		FScopedScheduleMode ScheduleMode(Mode);
+		const TCHAR* ModeName = ModeNames[static_cast<int32>(Mode)];
+
+		// Steps are only checked once the pools, queues and timer manager have stopped growing
+		bool bWarm = false;
+		auto Step = [&](const TCHAR* StepName, auto&& Function)
+		{
+			Allocations.Reset();
+			Function();
+			const int32 NumAllocations = Allocations.GetNum();
+
+			const FAnimNotifyProTimeline* Timeline = Player->GetTimeline();
+			const int32 NumTimers = Timeline ? CountArmedTimers(TimerManager, *Timeline) : 0;
+			const int32 MaxAllocations = CountTimerManagerAllocations(NumTimers);
+			if (bWarm && NumAllocations > MaxAllocations)
+			{
+				AddError(FString::Printf(TEXT("ScheduleMode %s: %s made %d allocations, FTimerManager accounts for %d arming %d timers"),
+					ModeName, StepName, NumAllocations, MaxAllocations, NumTimers));
+			}
+		};
+
+		auto PlayThrough = [&]()
+		{
+			Step(TEXT("Play"), [&]() { Player->Play(World, Montage, TimeDilationActor); });
+			Step(TEXT("Dilation change"), [&]() { UPlayMontageProStatics::SetActorCustomTimeDilation(TimeDilationActor, 0.5f); });
+			Step(TEXT("Section jump"), [&]() { UPlayMontageProStatics::HandleSectionChange(Player, World, *Player->GetTimeline(), SecondSectionTime, false); });
+			Step(TEXT("Dilation change"), [&]() { UPlayMontageProStatics::SetActorCustomTimeDilation(TimeDilationActor, 1.f); });
+			Step(TEXT("End"), [&]() { Player->End(); });
+		};
+
+		for (int32 Play = 0; Play < 32; Play++)
+		{
+			PlayThrough();
+		}
+
+		bWarm = true;
+		for (int32 Play = 0; Play < 32; Play++)
+		{
+			PlayThrough();
+		}
+	}
+
+	return true;
+}
+
+#endif
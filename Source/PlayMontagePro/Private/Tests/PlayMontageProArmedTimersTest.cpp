@@ -0,0 +1,69 @@
+// Copyright (c) Jared Taylor
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PlayMontageProStatics.h"
+#include "PlayMontageProSubsystem.h"
+#include "PlayMontageProTestHelpers.h"
+#include "PlayMontageProTestTypes.h"
+#include "Animation/AnimMontage.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "TimerManager.h"
+
+using namespace PlayMontagePro::Tests;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayMontageProArmedTimersTest, "PlayMontagePro.Timelines.ArmedTimers",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FPlayMontageProArmedTimersTest::RunTest(const FString& Parameters)
+{
+	FScopedTestWorld TestWorld;
+	UWorld* World = TestWorld.Get();
+	UPlayMontageProSubsystem* Subsystem = TestWorld.GetSubsystem();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	UAnimMontage* Montage = CreateMontage(4.f, 2, 8, 4);
+	const float SecondSectionTime = Montage->CompositeSections[1].GetTime();
+	AActor* TimeDilationActor = World->SpawnActor<AActor>();
+	UPlayMontageProTestPlayer* Player = NewObject<UPlayMontageProTestPlayer>();
+	const FTimerManager& TimerManager = World->GetTimerManager();
+
+	static const TCHAR* ModeNames[] = { TEXT("Timers"), TEXT("Cursor"), TEXT("Tick") };
+	for (const EAnimNotifyProScheduleMode Mode : { EAnimNotifyProScheduleMode::Timers, EAnimNotifyProScheduleMode::Cursor, EAnimNotifyProScheduleMode::Tick })
+	{
+		FScopedScheduleMode ScheduleMode(Mode);
+		const TCHAR* ModeName = ModeNames[static_cast<int32>(Mode)];
+
+		// The live count has to agree with the timer manager after every step, including timers fired, re-armed from their own callback and cleared
+		auto Step = [&](const TCHAR* StepName, auto&& Function)
+		{
+			Function();
+			const FAnimNotifyProTimeline* Timeline = Player->GetTimeline();
+			const int32 NumTimers = Timeline ? CountArmedTimers(TimerManager, *Timeline) : 0;
+			TestEqual(FString::Printf(TEXT("ScheduleMode %s: timers armed after %s"), ModeName, StepName), Subsystem->GetNumArmedTimers(), NumTimers);
+		};
+
+		Step(TEXT("Play"), [&]() { Player->Play(World, Montage, TimeDilationActor); });
+		Step(TEXT("Advance"), [&]() { TestWorld.Advance(0.1f, 4); });
+		Step(TEXT("Dilation change"), [&]() { UPlayMontageProStatics::SetActorCustomTimeDilation(TimeDilationActor, 0.5f); });
+		Step(TEXT("Advance"), [&]() { TestWorld.Advance(0.1f, 4); });
+		Step(TEXT("Section jump"), [&]() { UPlayMontageProStatics::HandleSectionChange(Player, World, *Player->GetTimeline(), SecondSectionTime, false); });
+		Step(TEXT("Dilation change"), [&]() { UPlayMontageProStatics::SetActorCustomTimeDilation(TimeDilationActor, 1.f); });
+		Step(TEXT("Advance"), [&]() { TestWorld.Advance(0.1f, 4); });
+		Step(TEXT("End"), [&]() { Player->End(EAnimNotifyProEventType::OnInterrupted); });
+
+		// Nothing outlives the play, and nothing was uncounted twice
+		TestWorld.Advance(0.1f, 40);
+		TestEqual(FString::Printf(TEXT("ScheduleMode %s: timers armed once released"), ModeName), Subsystem->GetNumArmedTimers(), 0);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,128 @@
+// Copyright (c) Jared Taylor
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PlayMontageProSubsystem.h"
+#include "PlayMontageProTestHelpers.h"
+#include "PlayMontageProTestTypes.h"
+#include "Animation/AnimMontage.h"
+
+using namespace PlayMontagePro::Tests;
+
+namespace PlayMontagePro::Tests
+{
+	static int32 CountNotifies(const UAnimMontage* Montage)
+	{
+		int32 NumNotifies = 0;
+		for (const FAnimNotifyEvent& NotifyEvent : Montage->Notifies)
+		{
+			if (const UAnimNotifyProTestNotify* Notify = Cast<UAnimNotifyProTestNotify>(NotifyEvent.Notify))
+			{
+				NumNotifies += Notify->NumNotifies;
+			}
+		}
+		return NumNotifies;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayMontageProStaleEventHandleTest, "PlayMontagePro.Timelines.StaleEventHandle",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FPlayMontageProStaleEventHandleTest::RunTest(const FString& Parameters)
+{
+	FScopedTestWorld TestWorld;
+	UPlayMontageProSubsystem* Subsystem = TestWorld.GetSubsystem();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	static constexpr int32 NumNotifies = 4;
+	UAnimMontage* Montage = CreateMontage(2.f, 1, NumNotifies, 0);
+	UPlayMontageProTestPlayer* Player = NewObject<UPlayMontageProTestPlayer>();
+
+	// The handle a timer armed by the first play is bound to
+	const FAnimNotifyProTimeline* Timeline = Player->Play(TestWorld.Get(), Montage);
+	if (!TestNotNull(TEXT("Timeline"), Timeline))
+	{
+		return false;
+	}
+	FAnimNotifyProEventHandle StaleHandle;
+	StaleHandle.TimelineIndex = Timeline->PoolIndex;
+	StaleHandle.EventIndex = 0;
+	StaleHandle.EventGeneration = Timeline->EventGeneration;
+	StaleHandle.Generation = Timeline->Generation;
+	TestNotNull(TEXT("Handle resolves while its play is active"), Subsystem->GetEvent(StaleHandle));
+
+	// Replaying the montage in the same slot keeps the events and their generation
+	Player->End();
+	Timeline = Player->Play(TestWorld.Get(), Montage);
+	TestEqual(TEXT("Replay reuses the slot"), Timeline->PoolIndex, StaleHandle.TimelineIndex);
+	TestEqual(TEXT("Replay reuses the events"), Timeline->EventGeneration, StaleHandle.EventGeneration);
+	TestNull(TEXT("Handle from the previous play no longer resolves"), Subsystem->GetEvent(StaleHandle));
+
+	FAnimNotifyProEventHandle Handle = StaleHandle;
+	Handle.Generation = Timeline->Generation;
+	TestNotNull(TEXT("Handle from the replay resolves"), Subsystem->GetEvent(Handle));
+
+	// Every notify fires once for the replay
+	TestWorld.Advance(0.1f, 25);
+	TestEqual(TEXT("Notifies fired by the replay"), CountNotifies(Montage), NumNotifies);
+
+	Player->End();
+	TestNull(TEXT("Handle no longer resolves once released"), Subsystem->GetEvent(Handle));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayMontageProEventRecyclingTest, "PlayMontagePro.Timelines.EventRecycling",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FPlayMontageProEventRecyclingTest::RunTest(const FString& Parameters)
+{
+	FScopedTestWorld TestWorld;
+	if (!TestNotNull(TEXT("Subsystem"), TestWorld.GetSubsystem()))
+	{
+		return false;
+	}
+
+	// Tick scheduling arms no timers, so the only allocations left are the events' own
+	FScopedScheduleMode ScheduleMode(EAnimNotifyProScheduleMode::Tick);
+
+	// One montage fits the events' inline storage, the other spills to the heap, both play at once so each keeps its own slot
+	UAnimMontage* InlineMontage = CreateMontage(2.f, 1, 8, 4);
+	UAnimMontage* HeapMontage = CreateMontage(2.f, 1, 32, 16);
+	UPlayMontageProTestPlayer* InlinePlayer = NewObject<UPlayMontageProTestPlayer>();
+	UPlayMontageProTestPlayer* HeapPlayer = NewObject<UPlayMontageProTestPlayer>();
+
+	auto PlayBoth = [&]()
+	{
+		InlinePlayer->Play(TestWorld.Get(), InlineMontage);
+		HeapPlayer->Play(TestWorld.Get(), HeapMontage);
+		InlinePlayer->End();
+		HeapPlayer->End();
+	};
+
+	// Warm up the pool, the schedules and the subsystem's queues until they stop growing
+	for (int32 Play = 0; Play < 32; Play++)
+	{
+		PlayBoth();
+	}
+
+	FScopedAllocationCounter Allocations;
+	if (!Allocations.IsCounting())
+	{
+		AddWarning(TEXT("Allocations don't go through GMalloc on this platform, nothing to count"));
+		return true;
+	}
+
+	for (int32 Play = 0; Play < 32; Play++)
+	{
+		PlayBoth();
+	}
+	TestEqual(TEXT("Allocations replaying the montages in their recycled slots"), Allocations.GetNum(), 0);
+	return true;
+}
+
+#endif
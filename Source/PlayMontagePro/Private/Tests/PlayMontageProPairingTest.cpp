@@ -0,0 +1,87 @@
+// Copyright (c) Jared Taylor
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PlayMontageProStatics.h"
+#include "PlayMontageProTestHelpers.h"
+#include "Animation/AnimMontage.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayMontageProPairingTest, "PlayMontagePro.Notifies.Pairing",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FPlayMontageProPairingTest::RunTest(const FString& Parameters)
+{
+	// Every event of every play resolves its pair, as the ensure and historic passes do
+	static constexpr int32 NumPlays = 200;
+
+	for (const int32 NumNotifyStates : { 8, 64, 256 })
+	{
+		UAnimMontage* Montage = PlayMontagePro::Tests::CreateMontage(10.f, 1, 0, NumNotifyStates);
+
+		FAnimNotifyProTimeline Timeline;
+		UPlayMontageProStatics::GatherNotifies(Montage, Montage, Timeline, Montage->GetSectionName(0), 0.f);
+		FAnimNotifyProEventArray& Notifies = Timeline.Notifies;
+		if (!TestEqual(TEXT("Gathered events"), Notifies.Num(), NumNotifyStates * 2))
+		{
+			return false;
+		}
+
+		// Before, a NotifyId map was built every play and the paired event was found by searching the events for its id
+		int32 LegacyPairs = 0;
+		const double LegacyStart = FPlatformTime::Seconds();
+		for (int32 Play = 0; Play < NumPlays; Play++)
+		{
+			TMap<uint32, uint32> NotifyStatePairs;
+			for (int32 Index = 0; Index < Notifies.Num(); Index++)
+			{
+				const int32 PairIndex = Timeline.GetEntry(Index).PairIndex;
+				if (PairIndex != INDEX_NONE)
+				{
+					NotifyStatePairs.Add(Notifies[Index].NotifyId, Notifies[PairIndex].NotifyId);
+				}
+			}
+
+			for (const FAnimNotifyProEvent& Event : Notifies)
+			{
+				if (const uint32* PairId = NotifyStatePairs.Find(Event.NotifyId))
+				{
+					const uint32 NotifyId = *PairId;
+					LegacyPairs += Notifies.ContainsByPredicate([NotifyId](const FAnimNotifyProEvent& Other) { return Other.NotifyId == NotifyId; }) ? 1 : 0;
+				}
+			}
+		}
+		const double LegacySeconds = FPlatformTime::Seconds() - LegacyStart;
+
+		// Now the pair is the event at the schedule entry's PairIndex
+		int32 IndexedPairs = 0;
+		const double IndexedStart = FPlatformTime::Seconds();
+		for (int32 Play = 0; Play < NumPlays; Play++)
+		{
+			for (const FAnimNotifyProEvent& Event : Notifies)
+			{
+				IndexedPairs += UPlayMontageProStatics::FindNotifyStatePair(Timeline, Event) ? 1 : 0;
+			}
+		}
+		const double IndexedSeconds = FPlatformTime::Seconds() - IndexedStart;
+
+		TestEqual(FString::Printf(TEXT("Pairs resolved with %d notify states"), NumNotifyStates), IndexedPairs, LegacyPairs);
+		for (const FAnimNotifyProEvent& Event : Notifies)
+		{
+			const FAnimNotifyProEvent* Pair = UPlayMontageProStatics::FindNotifyStatePair(Timeline, Event);
+			if (!TestTrue(TEXT("Pairs resolve back to their event"), Pair && UPlayMontageProStatics::FindNotifyStatePair(Timeline, *Pair) == &Event))
+			{
+				break;
+			}
+		}
+
+		// Wall-clock timings vary with the machine's load, so they are only reported
+		AddInfo(FString::Printf(TEXT("%d notify states: pairing took %.2fus per play with the NotifyId map, %.2fus by index"),
+			NumNotifyStates, LegacySeconds * 1e6 / NumPlays, IndexedSeconds * 1e6 / NumPlays));
+	}
+
+	return true;
+}
+
+#endif
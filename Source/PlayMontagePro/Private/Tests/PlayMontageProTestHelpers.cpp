@@ -0,0 +1,173 @@
+// Copyright (c) Jared Taylor
+
+#include "PlayMontageProTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PlayMontageProSubsystem.h"
+#include "PlayMontageProTestTypes.h"
+#include "Animation/AnimMontage.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Package.h"
+
+namespace PlayMontagePro::Tests
+{
+	UAnimMontage* CreateMontage(float Length, int32 NumSections, int32 NumNotifies, int32 NumNotifyStates)
+	{
+		UAnimMontage* Montage = NewObject<UAnimMontage>(GetTransientPackage(), NAME_None, RF_Transient);
+
+		// The play length isn't settable outside of the animation data model, and the last section ends at it
+		if (FFloatProperty* LengthProperty = FindFProperty<FFloatProperty>(UAnimSequenceBase::StaticClass(), TEXT("SequenceLength")))
+		{
+			LengthProperty->SetPropertyValue_InContainer(Montage, Length);
+		}
+
+		Montage->CompositeSections.Reset();
+		const float SectionLength = Length / FMath::Max(NumSections, 1);
+		for (int32 Index = 0; Index < NumSections; Index++)
+		{
+			FCompositeSection& Section = Montage->CompositeSections.AddDefaulted_GetRef();
+			Section.SectionName = FName(TEXT("Section"), Index + 1);
+			Section.NextSectionName = Index + 1 < NumSections ? FName(TEXT("Section"), Index + 2) : NAME_None;
+			Section.SetTime(Index * SectionLength);
+		}
+
+		for (int32 Index = 0; Index < NumNotifies; Index++)
+		{
+			FAnimNotifyEvent& NotifyEvent = Montage->Notifies.AddDefaulted_GetRef();
+			NotifyEvent.Notify = NewObject<UAnimNotifyProTestNotify>(Montage);
+			NotifyEvent.SetTime((Index + 0.5f) * Length / NumNotifies);
+		}
+
+		for (int32 Index = 0; Index < NumNotifyStates; Index++)
+		{
+			const float Spacing = Length / NumNotifyStates;
+			FAnimNotifyEvent& NotifyEvent = Montage->Notifies.AddDefaulted_GetRef();
+			NotifyEvent.NotifyStateClass = NewObject<UAnimNotifyStateProTestState>(Montage);
+			NotifyEvent.SetTime((Index + 0.25f) * Spacing);
+			NotifyEvent.SetDuration(Spacing * 0.5f);
+		}
+
+		return Montage;
+	}
+
+	int32 CountArmedTimers(const FTimerManager& TimerManager, const FAnimNotifyProTimeline& Timeline)
+	{
+		int32 NumTimers = TimerManager.IsTimerActive(Timeline.CursorTimer) ? 1 : 0;
+		for (const FAnimNotifyProEvent& Event : Timeline.Notifies)
+		{
+			NumTimers += TimerManager.IsTimerActive(Event.Timer) ? 1 : 0;
+		}
+		return NumTimers;
+	}
+
+	FScopedTestWorld::FScopedTestWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false);
+		GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+	}
+
+	FScopedTestWorld::~FScopedTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	UPlayMontageProSubsystem* FScopedTestWorld::GetSubsystem() const
+	{
+		return UPlayMontageProSubsystem::Get(World);
+	}
+
+	void FScopedTestWorld::Advance(float DeltaTime, int32 NumFrames)
+	{
+		UPlayMontageProSubsystem* Subsystem = GetSubsystem();
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			// The timer manager only ticks once per frame
+			GFrameCounter++;
+			World->TimeSeconds += DeltaTime;
+			World->GetTimerManager().Tick(DeltaTime);
+			if (Subsystem->IsTickable())
+			{
+				Subsystem->Tick(DeltaTime);
+			}
+		}
+	}
+
+	static IConsoleVariable* FindScheduleModeCVar()
+	{
+		return IConsoleManager::Get().FindConsoleVariable(TEXT("PlayMontagePro.ScheduleMode"));
+	}
+
+	FScopedScheduleMode::FScopedScheduleMode(EAnimNotifyProScheduleMode ScheduleMode)
+	{
+		IConsoleVariable* CVar = FindScheduleModeCVar();
+		PreviousMode = CVar->GetInt();
+		CVar->Set(static_cast<int32>(ScheduleMode), ECVF_SetByCode);
+	}
+
+	FScopedScheduleMode::~FScopedScheduleMode()
+	{
+		FindScheduleModeCVar()->Set(PreviousMode, ECVF_SetByCode);
+	}
+
+	FScopedAllocationCounter::FScopedAllocationCounter()
+	{
+		InnerMalloc = GMalloc;
+		GMalloc = this;
+
+		// Check the allocations actually go through GMalloc before trusting the count
+		FMemory::Free(FMemory::Malloc(16));
+		bCounting = NumAllocations > 0;
+		NumAllocations = 0;
+	}
+
+	FScopedAllocationCounter::~FScopedAllocationCounter()
+	{
+		GMalloc = InnerMalloc;
+	}
+
+	void* FScopedAllocationCounter::Malloc(SIZE_T Count, uint32 Alignment)
+	{
+		if (IsInGameThread())
+		{
+			NumAllocations++;
+		}
+		return InnerMalloc->Malloc(Count, Alignment);
+	}
+
+	void* FScopedAllocationCounter::Realloc(void* Original, SIZE_T Count, uint32 Alignment)
+	{
+		// Reallocating to nothing is a free
+		if (Count > 0 && IsInGameThread())
+		{
+			NumAllocations++;
+		}
+		return InnerMalloc->Realloc(Original, Count, Alignment);
+	}
+
+	void FScopedAllocationCounter::Free(void* Original)
+	{
+		InnerMalloc->Free(Original);
+	}
+
+	bool FScopedAllocationCounter::GetAllocationSize(void* Original, SIZE_T& SizeOut)
+	{
+		return InnerMalloc->GetAllocationSize(Original, SizeOut);
+	}
+
+	SIZE_T FScopedAllocationCounter::QuantizeSize(SIZE_T Count, uint32 Alignment)
+	{
+		return InnerMalloc->QuantizeSize(Count, Alignment);
+	}
+
+	bool FScopedAllocationCounter::IsInternallyThreadSafe() const
+	{
+		return InnerMalloc->IsInternallyThreadSafe();
+	}
+}
+
+#endif
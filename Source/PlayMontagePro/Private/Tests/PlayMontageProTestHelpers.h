@@ -0,0 +1,87 @@
+// Copyright (c) Jared Taylor
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class FTimerManager;
+class UAnimMontage;
+class UWorld;
+class UPlayMontageProSubsystem;
+struct FAnimNotifyProTimeline;
+enum class EAnimNotifyProScheduleMode : uint8;
+
+namespace PlayMontagePro::Tests
+{
+	/**
+	 * Builds a transient montage for the automation tests, without any animation in its slots.
+	 * @param Length The montage's play length.
+	 * @param NumSections Sections of equal length, each linked to the next and the last to none.
+	 * @param NumNotifies UAnimNotifyProTestNotify instances spread evenly across the montage.
+	 * @param NumNotifyStates UAnimNotifyStateProTestState instances spread evenly across the montage, each ending before the next begins.
+	 */
+	UAnimMontage* CreateMontage(float Length, int32 NumSections, int32 NumNotifies, int32 NumNotifyStates);
+
+	/** @return Number of the timeline's timers that are armed, per event or for its cursor */
+	int32 CountArmedTimers(const FTimerManager& TimerManager, const FAnimNotifyProTimeline& Timeline);
+
+	/** Game world with its own world context, for the tests that need a UPlayMontageProSubsystem and a timer manager */
+	class FScopedTestWorld
+	{
+	public:
+		FScopedTestWorld();
+		~FScopedTestWorld();
+
+		UWorld* Get() const { return World; }
+		UPlayMontageProSubsystem* GetSubsystem() const;
+
+		/** Advances world time a frame at a time, ticking the timer manager then the subsystem like the world would */
+		void Advance(float DeltaTime, int32 NumFrames = 1);
+
+	private:
+		UWorld* World = nullptr;
+	};
+
+	/** Sets PlayMontagePro.ScheduleMode while in scope, it applies to the montages played meanwhile */
+	class FScopedScheduleMode
+	{
+	public:
+		explicit FScopedScheduleMode(EAnimNotifyProScheduleMode ScheduleMode);
+		~FScopedScheduleMode();
+
+	private:
+		int32 PreviousMode = 0;
+	};
+
+	/**
+	 * Counts the heap allocations made on the game thread while in scope, by standing in for GMalloc.
+	 * Platforms that inline their allocator bypass GMalloc, IsCounting is false there and nothing is counted.
+	 */
+	class FScopedAllocationCounter : public FMalloc
+	{
+	public:
+		FScopedAllocationCounter();
+		virtual ~FScopedAllocationCounter() override;
+
+		bool IsCounting() const { return bCounting; }
+		int32 GetNum() const { return NumAllocations; }
+		void Reset() { NumAllocations = 0; }
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override;
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override;
+		virtual void Free(void* Original) override;
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override;
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override;
+		virtual bool IsInternallyThreadSafe() const override;
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("PlayMontageProAllocationCounter"); }
+
+	private:
+		FMalloc* InnerMalloc = nullptr;
+		int32 NumAllocations = 0;
+		bool bCounting = false;
+	};
+}
+
+#endif
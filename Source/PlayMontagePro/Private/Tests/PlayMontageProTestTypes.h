@@ -0,0 +1,105 @@
+// Copyright (c) Jared Taylor
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimNotifyPro.h"
+#include "AnimNotifyStatePro.h"
+#include "PlayMontageProInterface.h"
+#include "PlayMontageProStatics.h"
+#include "PlayMontageProSubsystem.h"
+#include "Animation/AnimMontage.h"
+#include "PlayMontageProTestTypes.generated.h"
+
+/** Notify placed on the montages built by the automation tests, counts its callbacks */
+UCLASS(NotBlueprintable, HideDropdown)
+class UAnimNotifyProTestNotify : public UAnimNotifyPro
+{
+	GENERATED_BODY()
+
+public:
+	int32 NumNotifies = 0;
+
+	virtual void OnNotify(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, const FAnimNotifyProContext& Context) override
+	{
+		NumNotifies++;
+	}
+};
+
+/** Notify state placed on the montages built by the automation tests, counts its callbacks */
+UCLASS(NotBlueprintable, HideDropdown)
+class UAnimNotifyStateProTestState : public UAnimNotifyStatePro
+{
+	GENERATED_BODY()
+
+public:
+	int32 NumBegins = 0;
+	int32 NumEnds = 0;
+
+	virtual void OnNotifyBegin(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float TotalDuration, const FAnimNotifyProContext& Context) override
+	{
+		NumBegins++;
+	}
+
+	virtual void OnNotifyEnd(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, const FAnimNotifyProContext& Context) override
+	{
+		NumEnds++;
+	}
+};
+
+/**
+ * Stands in for a PlayMontage node in the automation tests, without a mesh or anim instance.
+ * Acquires its timeline from the world's UPlayMontageProSubsystem and broadcasts through the statics like the callback proxy.
+ */
+UCLASS(Transient)
+class UPlayMontageProTestPlayer : public UObject, public IPlayMontageProInterface
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TObjectPtr<UAnimMontage> Montage = nullptr;
+
+	FAnimNotifyProTimelineHandle TimelineHandle;
+
+	int32 NumBroadcasts = 0;
+
+	/** Bound to timers by the tests that compare against what FTimerManager allocates for the subsystem's timers */
+	void OnTestTimer(FAnimNotifyProEventHandle Handle) {}
+
+	/** Plays the montage from its first section the way the PlayMontage nodes do, from acquiring a timeline to setting up its timers */
+	FAnimNotifyProTimeline* Play(const UWorld* World, UAnimMontage* InMontage, AActor* TimeDilationActor = nullptr)
+	{
+		Montage = InMontage;
+		FAnimNotifyProTimeline* Timeline = UPlayMontageProSubsystem::AcquireTimeline(World, this, this, TimelineHandle, TimeDilationActor, InMontage);
+		if (Timeline)
+		{
+			UPlayMontageProStatics::GatherNotifies(this, InMontage, *Timeline, InMontage->GetSectionName(0), 0.f);
+			UPlayMontageProStatics::HandleHistoricNotifies(*Timeline, false, this);
+			UPlayMontageProStatics::SetupNotifyTimers(this, World, *Timeline);
+		}
+		return Timeline;
+	}
+
+	/** Ends the play the way the PlayMontage nodes do, ensuring what is left to fire then releasing the timeline */
+	void End(EAnimNotifyProEventType EventType = EAnimNotifyProEventType::OnCompleted)
+	{
+		UPlayMontageProStatics::EnsureBroadcastNotifyEvents(EventType, this);
+		UPlayMontageProSubsystem::ReleaseTimeline(TimelineHandle);
+	}
+
+	// Begin IPlayMontageProInterface
+	virtual void BroadcastNotifyEvent(FAnimNotifyProEvent& Event, EAnimNotifyProTrigger Trigger) override
+	{
+		if (FAnimNotifyProTimeline* Timeline = GetTimeline())
+		{
+			NumBroadcasts++;
+			UPlayMontageProStatics::BroadcastNotifyEvent(*Timeline, Event, this, Trigger);
+		}
+	}
+
+	virtual UAnimMontage* GetMontage() const override { return Montage; }
+	virtual USkeletalMeshComponent* GetMesh() const override { return nullptr; }
+	virtual FAnimNotifyProTimeline* GetTimeline() const override { return TimelineHandle.Get(); }
+	// ~End IPlayMontageProInterface
+};
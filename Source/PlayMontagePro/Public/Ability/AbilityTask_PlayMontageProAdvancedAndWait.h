@@ -104,16 +104,17 @@ public:
 	
 public:
 	// Begin IPlayMontageProInterface
-	virtual void BroadcastNotifyEvent(FAnimNotifyProEvent& Event) override
+	virtual void BroadcastNotifyEvent(FAnimNotifyProEvent& Event, EAnimNotifyProTrigger Trigger) override
 	{
-		UPlayMontageProStatics::BroadcastNotifyEvent(Event,
-			UPlayMontageProStatics::FindNotifyStatePair(Notifies, NotifyStatePairs, Event), this);
+		if (FAnimNotifyProTimeline* Timeline = GetTimeline())
+		{
+			UPlayMontageProStatics::BroadcastNotifyEvent(*Timeline, Event, this, Trigger);
+		}
 	}
 
 	virtual UAnimMontage* GetMontage() const override final;
 	virtual USkeletalMeshComponent* GetMesh() const override final;
-
-	virtual FTimerDelegate CreateTimerDelegate(FAnimNotifyProEvent& Event) override { return FTimerDelegate::CreateUObject(this, &IPlayMontageProInterface::OnNotifyTimer, &Event); }
+	virtual FAnimNotifyProTimeline* GetTimeline() const override final { return TimelineHandle.Get(); }
 	// ~End IPlayMontageProInterface
 	
 protected:
@@ -175,19 +176,10 @@ protected:
 	UPROPERTY()
 	float OverrideBlendOutTimeOnEndAbility;
 
-	UPROPERTY()
-	uint32 NotifyId = 0;
-	
-	UPROPERTY()
-	TArray<FAnimNotifyProEvent> Notifies;
-	
-	/** Pairs notify state begin and end events by NotifyId, resolved against Notifies for live state */
-	UPROPERTY()
-	TMap<uint32, uint32> NotifyStatePairs;
+	/** Handle to the timeline in the world's UPlayMontageProSubsystem */
+	FAnimNotifyProTimelineHandle TimelineHandle;
 	
 	FDelegateHandle TickPoseHandle;
 
 	FDelegateHandle EventHandle;
-	
-	float TimeDilation = 1.f;
 };
@@ -62,7 +62,7 @@ public:
 	 * @param Rate Change to play the montage faster or slower
 	 * @param StartSection If not empty, named montage section to start from
 	 * @param bTriggerNotifiesBeforeStartTime Whether to trigger notifies before the starting position.
-	 * @param bEnableCustomTimeDilation Whether to enable custom time dilation for the montage. Requires the mesh component to tick pose. May have additional performance overhead.
+	 * @param bEnableCustomTimeDilation Whether to enable custom time dilation for the montage. Change it with SetActorCustomTimeDilation, or enable PlayMontagePro.PollTimeDilation if it is set directly.
 	 * @param bStopWhenAbilityEnds If true, this montage will be aborted if the ability ends normally. It is always stopped when the ability is explicitly cancelled
 	 * @param AnimRootMotionTranslationScale Change to modify size of root motion or set to 0 to block it entirely
 	 * @param StartTimeSeconds Starting time offset in montage, this will be overridden by StartSection if that is also set
@@ -85,16 +85,17 @@ public:
 	
 public:
 	// Begin IPlayMontageProInterface
-	virtual void BroadcastNotifyEvent(FAnimNotifyProEvent& Event) override
+	virtual void BroadcastNotifyEvent(FAnimNotifyProEvent& Event, EAnimNotifyProTrigger Trigger) override
 	{
-		UPlayMontageProStatics::BroadcastNotifyEvent(Event,
-			UPlayMontageProStatics::FindNotifyStatePair(Notifies, NotifyStatePairs, Event), this);
+		if (FAnimNotifyProTimeline* Timeline = GetTimeline())
+		{
+			UPlayMontageProStatics::BroadcastNotifyEvent(*Timeline, Event, this, Trigger);
+		}
 	}
 
 	virtual UAnimMontage* GetMontage() const override final;
 	virtual USkeletalMeshComponent* GetMesh() const override final;
-
-	virtual FTimerDelegate CreateTimerDelegate(FAnimNotifyProEvent& Event) override { return FTimerDelegate::CreateUObject(this, &IPlayMontageProInterface::OnNotifyTimer, &Event); }
+	virtual FAnimNotifyProTimeline* GetTimeline() const override final { return TimelineHandle.Get(); }
 	// ~End IPlayMontageProInterface
 	
 protected:
@@ -141,17 +142,8 @@ protected:
 	UPROPERTY()
 	bool bAllowInterruptAfterBlendOut;
 
-	UPROPERTY()
-	uint32 NotifyId = 0;
-	
-	UPROPERTY()
-	TArray<FAnimNotifyProEvent> Notifies;
-		
-	/** Pairs notify state begin and end events by NotifyId, resolved against Notifies for live state */
-	UPROPERTY()
-	TMap<uint32, uint32> NotifyStatePairs;
+	/** Handle to the timeline in the world's UPlayMontageProSubsystem */
+	FAnimNotifyProTimelineHandle TimelineHandle;
 	
 	FDelegateHandle TickPoseHandle;
-	
-	float TimeDilation = 1.f;
 };
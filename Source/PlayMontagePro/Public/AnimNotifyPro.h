@@ -30,18 +30,46 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=AnimNotify)
 	EAnimNotifyLegacyType SimulatedProxyBehavior = EAnimNotifyLegacyType::Legacy;
 
+	/**
+	 * If disabled this notify is skipped for meshes below PlayMontagePro.Significance.Threshold when the montage starts, e.g. off-screen cosmetics.
+	 * Ignored if EnsureTriggerNotify is set, ensured notifies always fire.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=AnimNotify)
+	bool bCritical = true;
+
 #if WITH_EDITORONLY_DATA
 
 protected:
-	bool bHasBlueprintReceivedNotify;
+	/** Whether a Blueprint implements the unsupported Received_Notify, only set on the class default object */
+	bool bHasBlueprintReceivedNotify = false;
 	
 #endif
+
+private:
+	/** Whether a native subclass may override OnNotify, only set on the class default object */
+	uint8 bHasNativeOnNotify : 1;
+
+	/** Whether a Blueprint implements K2_OnNotify, only set on the class default object */
+	uint8 bHasBlueprintOnNotify : 1;
+
+	/** Whether the hooks above have been looked up since the class was last compiled or reloaded */
+	uint8 bCapabilitiesCached : 1;
+
+	/** Looks up which hooks the class implements, once per class on its default object rather than for every instance */
+	void CacheClassCapabilities();
+
+	/** @return The class default object, which holds the hooks the class implements, looked up on first use */
+	const UAnimNotifyPro* GetClassCapabilities() const;
 	
 public:
 	UAnimNotifyPro(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
+	/** Looks up the hooks of every class again on next use, after hot reload or reinstancing replaced classes */
+	static void InvalidateClassCapabilities();
+
 #if WITH_EDITOR
 	virtual EDataValidationResult IsDataValid(class FDataValidationContext& Context) const override;
+	virtual void PostCDOCompiled(const FPostCDOCompiledContext& Context) override;
 #endif
 	
 	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override final;
@@ -49,8 +77,17 @@ public:
 
 public:
 	virtual bool ShouldTriggerNotify(USkeletalMeshComponent* MeshComp) const;
+
+	/** @return Net contexts the notify never fires in, evaluated once when the montage's schedule is built */
+	virtual EAnimNotifyProNetFilter GetNetFilter() const;
 	
-	virtual void NotifyCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage);
+	virtual void NotifyCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, const FAnimNotifyProContext& Context);
+
+	/** Override to handle the notify in C++, Context describes when and why it fired */
+	virtual void OnNotify(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, const FAnimNotifyProContext& Context);
+
+	/** Called by the OnNotify that takes a context unless it is overridden, so existing overrides keep firing for one more release */
+	UE_DEPRECATED(5.4, "Override the OnNotify that takes an FAnimNotifyProContext instead, this overload will be removed in the next release.")
 	virtual void OnNotify(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage);
 	
 	UFUNCTION(BlueprintImplementableEvent, meta=(DisplayName="On Notify"))
@@ -30,26 +30,75 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=AnimNotify)
 	EAnimNotifyLegacyType SimulatedProxyBehavior = EAnimNotifyLegacyType::Legacy;
 
+	/**
+	 * If disabled this notify state is skipped for meshes below PlayMontagePro.Significance.Threshold when the montage starts, e.g. off-screen cosmetics.
+	 * Ignored if EnsureTriggerNotify is set, ensured notifies always fire.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=AnimNotify)
+	bool bCritical = true;
+
+	/**
+	 * How often OnNotifyTick is called while the notify state is active, in place of the engine's unsupported NotifyTick.
+	 * Ticks are batched by the world's UPlayMontageProSubsystem and follow the montage's play rate, time dilation and pauses.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Tick)
+	EAnimNotifyProTickInterval TickInterval = EAnimNotifyProTickInterval::None;
+
+	/** Ticks per second of montage time */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Tick, meta=(EditCondition="TickInterval==EAnimNotifyProTickInterval::FixedRate", EditConditionHides, ClampMin="0.1", UIMin="1", UIMax="60", ForceUnits="Hz"))
+	float TickRate = 10.f;
+
+	/** Frames between ticks */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Tick, meta=(EditCondition="TickInterval==EAnimNotifyProTickInterval::EveryNFrames", EditConditionHides, ClampMin="1", UIMin="1", UIMax="30"))
+	int32 TickFrames = 2;
+
 #if WITH_EDITORONLY_DATA
 
 protected:
-	bool bHasBlueprintNotifyBegin;
-	bool bHasBlueprintNotifyTick;
-	bool bHasBlueprintNotifyEnd;
+	/** Whether a Blueprint implements the unsupported Received_NotifyBegin, Received_NotifyTick or Received_NotifyEnd, only set on the class default object */
+	bool bHasBlueprintNotifyBegin = false;
+	bool bHasBlueprintNotifyTick = false;
+	bool bHasBlueprintNotifyEnd = false;
 
 #endif
+
+private:
+	/** Whether a native subclass may override OnNotifyBegin or OnNotifyEnd, only set on the class default object */
+	uint8 bHasNativeOnNotifyState : 1;
+
+	/** Whether a Blueprint implements K2_OnNotifyBegin, only set on the class default object */
+	uint8 bHasBlueprintOnNotifyBegin : 1;
+
+	/** Whether a Blueprint implements K2_OnNotifyEnd, only set on the class default object */
+	uint8 bHasBlueprintOnNotifyEnd : 1;
+
+	/** Whether a Blueprint implements K2_OnNotifyTick, only set on the class default object */
+	uint8 bHasBlueprintOnNotifyTick : 1;
+
+	/** Whether the hooks above have been looked up since the class was last compiled or reloaded */
+	uint8 bCapabilitiesCached : 1;
+
+	/** Looks up which hooks the class implements, once per class on its default object rather than for every instance */
+	void CacheClassCapabilities();
+
+	/** @return The class default object, which holds the hooks the class implements, looked up on first use */
+	const UAnimNotifyStatePro* GetClassCapabilities() const;
 	
 public:
 	UAnimNotifyStatePro(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
+	/** Looks up the hooks of every class again on next use, after hot reload or reinstancing replaced classes */
+	static void InvalidateClassCapabilities();
+
 #if WITH_EDITOR
 	virtual EDataValidationResult IsDataValid(class FDataValidationContext& Context) const override;
+	virtual void PostCDOCompiled(const FPostCDOCompiledContext& Context) override;
 #endif
 
 	bool WantsSimulatedProxyNotify(const USkeletalMeshComponent* MeshComp) const;
 	
 	virtual void NotifyBegin(USkeletalMeshComponent * MeshComp, UAnimSequenceBase * Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference) override final;
-	virtual void NotifyTick(USkeletalMeshComponent * MeshComp, UAnimSequenceBase * Animation, float FrameDeltaTime, const FAnimNotifyEventReference& EventReference) override final {}
+	virtual void NotifyTick(USkeletalMeshComponent * MeshComp, UAnimSequenceBase * Animation, float FrameDeltaTime, const FAnimNotifyEventReference& EventReference) override final;
 	virtual void NotifyEnd(USkeletalMeshComponent * MeshComp, UAnimSequenceBase * Animation, const FAnimNotifyEventReference& EventReference) override final;
 	
 	virtual void BranchingPointNotifyBegin(FBranchingPointNotifyPayload& BranchingPointPayload) override final {}
@@ -58,12 +107,31 @@ public:
 
 public:
 	virtual bool ShouldTriggerNotify(USkeletalMeshComponent* MeshComp) const;
+
+	/** @return Net contexts the notify never fires in, evaluated once when the montage's schedule is built */
+	virtual EAnimNotifyProNetFilter GetNetFilter() const;
 	
-	virtual void NotifyBeginCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float TotalDuration);
-	virtual void NotifyEndCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage);
+	virtual void NotifyBeginCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float TotalDuration, const FAnimNotifyProContext& Context);
+	virtual void NotifyEndCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, const FAnimNotifyProContext& Context);
+
+	/** @return True if the notify state ticks and something implements OnNotifyTick, checked when it begins */
+	bool WantsProTick() const;
+
+	/** Called by UPlayMontageProSubsystem at the TickInterval while the notify state is active */
+	virtual void NotifyTickCallback(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float DeltaTime);
 	
+	/** Override to handle the notify state in C++, Context describes when and why it fired */
+	virtual void OnNotifyBegin(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float TotalDuration, const FAnimNotifyProContext& Context);
+	virtual void OnNotifyEnd(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, const FAnimNotifyProContext& Context);
+
+	/** Called by the OnNotifyBegin and OnNotifyEnd that take a context unless they are overridden, so existing overrides keep firing for one more release */
+	UE_DEPRECATED(5.4, "Override the OnNotifyBegin that takes an FAnimNotifyProContext instead, this overload will be removed in the next release.")
 	virtual void OnNotifyBegin(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float TotalDuration);
+	UE_DEPRECATED(5.4, "Override the OnNotifyEnd that takes an FAnimNotifyProContext instead, this overload will be removed in the next release.")
 	virtual void OnNotifyEnd(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage);
+
+	/** Override to tick the notify state in C++, DeltaTime is the montage time elapsed since the last tick */
+	virtual void OnNotifyTick(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float DeltaTime);
 	
 	UFUNCTION(BlueprintImplementableEvent, meta=(DisplayName="On Notify Begin"))
 	bool K2_OnNotifyBegin(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float TotalDuration) const;
@@ -71,6 +139,9 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, meta=(DisplayName="On Notify End"))
 	bool K2_OnNotifyEnd(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage) const;
 
+	UFUNCTION(BlueprintImplementableEvent, meta=(DisplayName="On Notify Tick"))
+	bool K2_OnNotifyTick(USkeletalMeshComponent* MeshComp, UAnimMontage* Montage, float DeltaTime) const;
+
 #if WITH_EDITOR
 	virtual bool CanBePlaced(UAnimSequenceBase* Animation) const override
 	{
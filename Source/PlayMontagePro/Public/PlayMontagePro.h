@@ -2,7 +2,43 @@
 
 #pragma once
 
+#include "Logging/LogMacros.h"
 #include "Modules/ModuleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+
+class UObject;
+enum class EReloadCompleteReason;
+
+PLAYMONTAGEPRO_API DECLARE_LOG_CATEGORY_EXTERN(LogPlayMontagePro, Log, All);
+
+// Use "stat PlayMontagePro" in game, the same numbers are recorded to the PlayMontagePro CSV category
+DECLARE_STATS_GROUP(TEXT("PlayMontagePro"), STATGROUP_PlayMontagePro, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gather"), STAT_PlayMontagePro_Gather, STATGROUP_PlayMontagePro, PLAYMONTAGEPRO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Setup"), STAT_PlayMontagePro_Setup, STATGROUP_PlayMontagePro, PLAYMONTAGEPRO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dispatch"), STAT_PlayMontagePro_Dispatch, STATGROUP_PlayMontagePro, PLAYMONTAGEPRO_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Timelines"), STAT_PlayMontagePro_ActiveTimelines, STATGROUP_PlayMontagePro, PLAYMONTAGEPRO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Timers Armed"), STAT_PlayMontagePro_TimersArmed, STATGROUP_PlayMontagePro, PLAYMONTAGEPRO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Events Gathered"), STAT_PlayMontagePro_EventsGathered, STATGROUP_PlayMontagePro, PLAYMONTAGEPRO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Events Fired"), STAT_PlayMontagePro_EventsFired, STATGROUP_PlayMontagePro, PLAYMONTAGEPRO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Events Ensured"), STAT_PlayMontagePro_EventsEnsured, STATGROUP_PlayMontagePro, PLAYMONTAGEPRO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Events Skipped"), STAT_PlayMontagePro_EventsSkipped, STATGROUP_PlayMontagePro, PLAYMONTAGEPRO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Section Changes"), STAT_PlayMontagePro_SectionChanges, STATGROUP_PlayMontagePro, PLAYMONTAGEPRO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Retimes"), STAT_PlayMontagePro_Retimes, STATGROUP_PlayMontagePro, PLAYMONTAGEPRO_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(PLAYMONTAGEPRO_API, PlayMontagePro);
+
+/** Times the scope for both the stat and the CSV profiler, e.g. PLAYMONTAGEPRO_SCOPE_TIME(Gather) */
+#define PLAYMONTAGEPRO_SCOPE_TIME(Stat) \
+	SCOPE_CYCLE_COUNTER(STAT_PlayMontagePro_##Stat); \
+	CSV_SCOPED_TIMING_STAT(PlayMontagePro, Stat)
+
+/** Adds to the frame's counter for both the stat and the CSV profiler, e.g. PLAYMONTAGEPRO_COUNT(EventsFired, 1) */
+#define PLAYMONTAGEPRO_COUNT(Stat, Amount) \
+	INC_DWORD_STAT_BY(STAT_PlayMontagePro_##Stat, Amount); \
+	CSV_CUSTOM_STAT(PlayMontagePro, Stat, static_cast<int32>(Amount), ECsvCustomStatOp::Accumulate)
 
 class FPlayMontageProModule : public IModuleInterface
 {
@@ -11,4 +47,9 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap);
+	void OnReloadComplete(EReloadCompleteReason Reason);
+	void InvalidateNotifyCapabilities();
 };
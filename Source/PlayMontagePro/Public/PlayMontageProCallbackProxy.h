@@ -19,6 +19,10 @@ struct FBranchingPointNotifyPayload;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMontageProPlayDelegate, FName, NotifyName);
 
+/**
+ * Proxy behind the Blueprint PlayMontagePro node, pooled per world by UPlayMontageProSubsystem.
+ * Once its montage has ended the proxy is only reused if nothing listens to it or references it any more, otherwise GC collects it.
+ */
 UCLASS()
 class PLAYMONTAGEPRO_API UPlayMontageProCallbackProxy : public UObject, public IPlayMontageProInterface
 {
@@ -36,21 +40,14 @@ class PLAYMONTAGEPRO_API UPlayMontageProCallbackProxy : public UObject, public I
 	UPROPERTY(BlueprintAssignable)
 	FOnMontageProPlayDelegate OnInterrupted;
 
-	UPROPERTY()
-	uint32 NotifyId = 0;
-
 	UPROPERTY()
 	TWeakObjectPtr<UAnimMontage> Montage;
 
 	UPROPERTY()
 	TWeakObjectPtr<USkeletalMeshComponent> MeshComp;
 	
-	UPROPERTY()
-	TArray<FAnimNotifyProEvent> Notifies;
-		
-	/** Pairs notify state begin and end events by NotifyId, resolved against Notifies for live state */
-	UPROPERTY()
-	TMap<uint32, uint32> NotifyStatePairs;
+	/** Handle to the timeline in the world's UPlayMontageProSubsystem */
+	FAnimNotifyProTimelineHandle TimelineHandle;
 	
 	// Called to perform the query internally
 	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true"))
@@ -64,18 +61,28 @@ class PLAYMONTAGEPRO_API UPlayMontageProCallbackProxy : public UObject, public I
 		bool bEnableCustomTimeDilation = false,
 		bool bShouldStopAllMontages = true);
 
+	/**
+	 * Unbinds everything the last play bound and clears the Blueprint's event bindings, so UPlayMontageProSubsystem can reuse the proxy.
+	 * Only called once the montage has ended and HasLiveListeners is false.
+	 */
+	void ResetForPool();
+
+	/** @return True if an object that is still alive is bound to OnCompleted, OnBlendOut or OnInterrupted */
+	bool HasLiveListeners() const;
+
 public:
 	// Begin IPlayMontageProInterface
-	virtual void BroadcastNotifyEvent(FAnimNotifyProEvent& Event) override
+	virtual void BroadcastNotifyEvent(FAnimNotifyProEvent& Event, EAnimNotifyProTrigger Trigger) override
 	{
-		UPlayMontageProStatics::BroadcastNotifyEvent(Event,
-			UPlayMontageProStatics::FindNotifyStatePair(Notifies, NotifyStatePairs, Event), this);
+		if (FAnimNotifyProTimeline* Timeline = GetTimeline())
+		{
+			UPlayMontageProStatics::BroadcastNotifyEvent(*Timeline, Event, this, Trigger);
+		}
 	}
 
 	virtual UAnimMontage* GetMontage() const override final { return Montage.IsValid() ? Montage.Get() : nullptr; }
 	virtual USkeletalMeshComponent* GetMesh() const override final { return MeshComp.IsValid() ? MeshComp.Get() : nullptr; }
-
-	virtual FTimerDelegate CreateTimerDelegate(FAnimNotifyProEvent& Event) override { return FTimerDelegate::CreateUObject(this, &IPlayMontageProInterface::OnNotifyTimer, &Event); }
+	virtual FAnimNotifyProTimeline* GetTimeline() const override final { return TimelineHandle.Get(); }
 	// ~End IPlayMontageProInterface
 	
 protected:
@@ -91,8 +98,6 @@ protected:
 	bool bFinished = false;
 	
 	FDelegateHandle TickPoseHandle;
-
-	float TimeDilation = 1.f;
 	
 	UFUNCTION()
 	void OnTickPose(USkinnedMeshComponent* SkinnedMeshComponent, float DeltaTime, bool NeedsValidRootMotion);
@@ -117,7 +122,7 @@ protected:
 	 * @param StartingPosition The position in the montage to start playing from.
 	 * @param StartingSection The section of the montage to start playing from.
 	 * @param bTriggerNotifiesBeforeStartTime Whether to trigger notifies before the starting position.
-	 * @param bEnableCustomTimeDilation Whether to enable custom time dilation for the montage. Requires the mesh component to tick pose. May have additional performance overhead.
+	 * @param bEnableCustomTimeDilation Whether to enable custom time dilation for the montage. Change it with SetActorCustomTimeDilation, or enable PlayMontagePro.PollTimeDilation if it is set directly.
 	 * @param bShouldStopAllMontages Whether to stop all other montages before playing this one.
 	 * @return True if the montage was played successfully, false otherwise.
 	 */
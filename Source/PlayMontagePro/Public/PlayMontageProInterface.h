@@ -24,14 +24,11 @@ class PLAYMONTAGEPRO_API IPlayMontageProInterface
 	GENERATED_BODY()
 
 public:
-	virtual void BroadcastNotifyEvent(FAnimNotifyProEvent& Event) = 0;
+	virtual void BroadcastNotifyEvent(FAnimNotifyProEvent& Event, EAnimNotifyProTrigger Trigger) = 0;
 
 	virtual UAnimMontage* GetMontage() const = 0;
 	virtual USkeletalMeshComponent* GetMesh() const = 0;
 
-	virtual FTimerDelegate CreateTimerDelegate(FAnimNotifyProEvent& Event) = 0;
-	void OnNotifyTimer(FAnimNotifyProEvent* Event)
-	{
-		BroadcastNotifyEvent(*Event);
-	}
+	/** @return The timeline acquired from UPlayMontageProSubsystem, or nullptr if it has not started or has been released */
+	virtual FAnimNotifyProTimeline* GetTimeline() const = 0;
 };
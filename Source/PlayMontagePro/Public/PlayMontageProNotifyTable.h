@@ -0,0 +1,46 @@
+// Copyright (c) Jared Taylor
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayMontageTypes.h"
+#include "Engine/AssetUserData.h"
+#include "PlayMontageProNotifyTable.generated.h"
+
+class UAnimMontage;
+
+/**
+ * Pro notify schedule baked onto a montage when it is cooked.
+ * Lets cooked builds skip scanning and casting the montage notifies the first time it is played.
+ * Uncooked or dynamic montages without a table fall back to UPlayMontageProStatics::BuildNotifySchedule.
+ */
+UCLASS(NotBlueprintable, HideDropdown)
+class PLAYMONTAGEPRO_API UPlayMontageProNotifyTable : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	/** Bumped whenever the schedule layout or build rules change, tables baked with an older version are ignored */
+	static constexpr int32 LatestVersion = 7;
+
+	/** Version the table was baked with */
+	UPROPERTY()
+	int32 Version = 0;
+
+	/** HashNotifies of the montage the table was baked from */
+	UPROPERTY()
+	uint32 NotifyHash = 0;
+
+	/** Time-sorted, section-bucketed schedule, identical to what BuildNotifySchedule would produce */
+	UPROPERTY()
+	FAnimNotifyProSchedule Schedule;
+
+	/** @return True if the table was baked with the latest version and matches the montage's sections and notifies */
+	bool IsValidFor(const UAnimMontage* Montage) const;
+
+	/**
+	 * Hash of the montage's sections and notify events, without casting the notifies.
+	 * Catches a montage whose notifies were edited after the table was baked.
+	 */
+	static uint32 HashNotifies(const UAnimMontage* Montage);
+};
@@ -0,0 +1,94 @@
+// Copyright (c) Jared Taylor
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayMontageTypes.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "PlayMontageProScheduleCache.generated.h"
+
+class UAnimMontage;
+
+/**
+ * Caches the Pro notify schedule for each montage so that it is only built once.
+ * Every play and section change reads the shared schedule instead of scanning and casting the montage notifies.
+ * Cooked builds build the schedule from UPlayMontageProNotifyTable when the montage has one.
+ * Schedules are invalidated when the montage is edited or reimported, and purged when the montage is garbage collected.
+ */
+UCLASS()
+class PLAYMONTAGEPRO_API UPlayMontageProScheduleCache : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** @return The cache, or nullptr if the engine is not available */
+	static UPlayMontageProScheduleCache* Get();
+
+	/**
+	 * Retrieves the schedule for the montage, building it on first use.
+	 * Falls back to building an uncached schedule if the cache is not available.
+	 * @param Montage The montage to retrieve the schedule for.
+	 * @return The shared, immutable schedule.
+	 */
+	static TSharedRef<const FAnimNotifyProSchedule> FindOrBuildSchedule(const UAnimMontage* Montage);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Retrieves the schedule for the montage, building it on first use */
+	TSharedRef<const FAnimNotifyProSchedule> GetSchedule(const UAnimMontage* Montage);
+
+	/** Discards the cached schedule for the montage, it will be rebuilt on next use */
+	void InvalidateSchedule(const UAnimMontage* Montage);
+
+	/** Discards every cached schedule */
+	void InvalidateAllSchedules();
+
+	/** @return Number of montages with a cached schedule */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int32 GetNumCachedSchedules() const { return Schedules.Num(); }
+
+	/** @return Number of schedule requests that were served from the cache */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int64 GetCacheHits() const { return CacheHits; }
+
+	/** @return Number of schedule requests that required building the schedule */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int64 GetCacheMisses() const { return CacheMisses; }
+
+	/** @return Number of cache misses that were served from a table baked onto the montage instead of scanning it */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int64 GetBakedTableLoads() const { return BakedTableLoads; }
+
+	/** @return Ratio of cache hits to total schedule requests, in the range 0-1 */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	float GetCacheHitRate() const;
+
+	/** Resets the hit and miss counters */
+	UFUNCTION(BlueprintCallable, Category=Animation)
+	void ResetCacheStats();
+
+protected:
+	void OnPostGarbageCollect();
+
+#if WITH_EDITOR
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+	void OnObjectTransacted(UObject* Object, const class FTransactionObjectEvent& TransactionEvent);
+	void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap);
+#endif
+
+	TMap<TObjectKey<UAnimMontage>, TSharedRef<const FAnimNotifyProSchedule>> Schedules;
+
+	int64 CacheHits = 0;
+	int64 CacheMisses = 0;
+	int64 BakedTableLoads = 0;
+
+	FDelegateHandle PostGarbageCollectHandle;
+
+#if WITH_EDITOR
+	FDelegateHandle ObjectPropertyChangedHandle;
+	FDelegateHandle ObjectTransactedHandle;
+	FDelegateHandle ObjectsReplacedHandle;
+#endif
+};
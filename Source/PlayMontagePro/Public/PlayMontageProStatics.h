@@ -7,8 +7,16 @@
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "PlayMontageProStatics.generated.h"
 
+class UAnimInstance;
 class UAnimMontage;
 class IPlayMontageProInterface;
+class USkeletalMeshComponent;
+class UWorld;
+struct FAnimMontageInstance;
+struct FAnimNotifyEventReference;
+
+/** Returns how significant the mesh is, in the range 0 to 1, e.g. from its distance to the camera or USignificanceManager */
+DECLARE_DELEGATE_RetVal_OneParam(float, FPlayMontageProSignificanceDelegate, const USkeletalMeshComponent* /*MeshComp*/);
 
 /**
  * Common utility functions for PlayMontagePro shared between different PlayMontage nodes.
@@ -27,94 +35,259 @@ public:
 	 */
 	UFUNCTION(BlueprintPure, Category=Animation)
 	static float GetMontagePlayRateScaledByDuration(const UAnimMontage* Montage, float Duration);
+
+	/**
+	 * Changes the play rate of a montage and retimes the Pro notifies of every PlayMontagePro node playing it on the anim instance.
+	 * Prefer this over Montage_SetPlayRate, which is only picked up when the next notify is due or when polling for time dilation.
+	 * @param AnimInstance The anim instance playing the montage.
+	 * @param Montage The montage to change the play rate of, or nullptr for every active montage.
+	 * @param NewPlayRate The new play rate.
+	 */
+	UFUNCTION(BlueprintCallable, Category=Animation)
+	static void SetMontagePlayRate(UAnimInstance* AnimInstance, const UAnimMontage* Montage, float NewPlayRate = 1.f);
+
+	/**
+	 * Moves a montage to a new position and seeks the Pro notifies of every PlayMontagePro node playing it on the anim instance.
+	 * Notifies passed over are triggered or skipped as they would be when starting from the position, seeking back replays them.
+	 * Prefer this over Montage_SetPosition, which is only picked up when the next notify is due.
+	 * @param AnimInstance The anim instance playing the montage.
+	 * @param Montage The montage to move, or nullptr for every active montage.
+	 * @param NewPosition The new position in the montage.
+	 */
+	UFUNCTION(BlueprintCallable, Category=Animation)
+	static void SetMontagePosition(UAnimInstance* AnimInstance, const UAnimMontage* Montage, float NewPosition);
+
+	/**
+	 * Pauses a montage and the Pro notifies of every PlayMontagePro node playing it on the anim instance.
+	 * Prefer this over Montage_Pause, which doesn't stop Pro notifies from firing.
+	 * @param AnimInstance The anim instance playing the montage.
+	 * @param Montage The montage to pause, or nullptr for every active montage.
+	 */
+	UFUNCTION(BlueprintCallable, Category=Animation)
+	static void PauseMontage(UAnimInstance* AnimInstance, const UAnimMontage* Montage);
+
+	/**
+	 * Resumes a montage and the Pro notifies of every PlayMontagePro node playing it on the anim instance.
+	 * Must be used to resume montages paused with PauseMontage.
+	 * @param AnimInstance The anim instance playing the montage.
+	 * @param Montage The montage to resume, or nullptr for every active montage.
+	 */
+	UFUNCTION(BlueprintCallable, Category=Animation)
+	static void ResumeMontage(UAnimInstance* AnimInstance, const UAnimMontage* Montage);
+
+	/**
+	 * Changes the actor's custom time dilation and retimes the Pro notifies of every PlayMontagePro node following it.
+	 * Prefer this over setting CustomTimeDilation directly, which is only picked up when the next notify is due or when polling for time dilation.
+	 * @param Actor The actor to change the custom time dilation of.
+	 * @param NewTimeDilation The new custom time dilation.
+	 */
+	UFUNCTION(BlueprintCallable, Category=Animation)
+	static void SetActorCustomTimeDilation(AActor* Actor, float NewTimeDilation = 1.f);
 	
 public:
 	/**
-	 * Gathers notifies from the montage and returns them in the Notifies array.
-	 * @param TaskOwner The ability task or outer owning this operation.
-	 * @param Montage The montage to gather notifies from.
-	 * @param NotifyId The current notify ID, which will be incremented for each notify found.
-	 * @param Notifies The array to store the gathered notifies.
-	 * @param NotifyStatePairs A map pairing notify state begin and end events by their NotifyId.
-	 * @param Section The section of the montage to gather notifies from.
-	 * @param StartPosition The starting position of the montage, used to calculate notify times.
-	 * @param TimeDilation The time dilation factor to apply to the notify times.
+	 * Scans the montage for Pro notifies and builds a time-sorted schedule bucketed by section.
+	 * This is the expensive path, prefer UPlayMontageProScheduleCache which only builds it once per montage.
+	 * @param Montage The montage to scan.
+	 * @param OutSchedule The schedule to populate, any existing entries are discarded.
 	 */
-	static void GatherNotifies(const UObject* TaskOwner, UAnimMontage* Montage, uint32& NotifyId, TArray<FAnimNotifyProEvent>& Notifies,
-		TMap<uint32, uint32>& NotifyStatePairs, const FName& Section, float StartPosition, float TimeDilation);
+	static void BuildNotifySchedule(const UAnimMontage* Montage, FAnimNotifyProSchedule& OutSchedule);
 
 	/**
-	 * Finds the live notify event in the Notifies array matching the given NotifyId.
-	 * Returns a pointer into the array so callers always see the up-to-date broadcast/skip flags.
-	 * @param Notifies The array of notifies to search.
-	 * @param NotifyId The unique NotifyId to find (0 is treated as invalid).
-	 * @return Pointer to the matching live event, or nullptr if not found.
+	 * Gathers notifies from the montage's cached schedule and returns them in the timeline's Notifies array, then enters the section.
+	 * Every section is gathered, so this only copies the schedule again if the timeline was last gathered from a different one.
+	 * Notify state begin and end events are linked to each other by FAnimNotifyProScheduleEntry::PairIndex.
+	 * @param TaskOwner The ability task or outer owning this operation.
+	 * @param Montage The montage to gather notifies from.
+	 * @param Timeline The timeline to store the gathered notifies in.
+	 * @param Section The section of the montage the clock starts in, only its notifies can fire.
+	 * @param StartPosition The starting position of the montage, the clock starts from it.
 	 */
-	static FAnimNotifyProEvent* FindNotifyById(TArray<FAnimNotifyProEvent>& Notifies, uint32 NotifyId);
+	static void GatherNotifies(const UObject* TaskOwner, UAnimMontage* Montage, FAnimNotifyProTimeline& Timeline,
+		const FName& Section, float StartPosition);
 
 	/**
 	 * Resolves the live paired notify state event (begin <-> end) for the given event.
-	 * The pair is looked up by NotifyId and resolved against the live Notifies array, so the
-	 * returned pointer reflects the current broadcast/skip state rather than a stale copy.
-	 * @param Notifies The array of notifies that owns the live events.
-	 * @param NotifyStatePairs The map pairing begin and end events by NotifyId.
-	 * @param Event The event whose pair should be resolved.
+	 * The pair is resolved by index against the live Notifies array, so the returned pointer
+	 * reflects the current broadcast/skip state rather than a stale copy.
+	 * @param Timeline The timeline that owns the live events.
+	 * @param Event The event whose pair should be resolved, must belong to the timeline's Notifies.
 	 * @return Pointer to the live paired event, or nullptr if the event has no pair.
 	 */
-	static FAnimNotifyProEvent* FindNotifyStatePair(TArray<FAnimNotifyProEvent>& Notifies,
-		const TMap<uint32, uint32>& NotifyStatePairs, const FAnimNotifyProEvent& Event);
+	static FAnimNotifyProEvent* FindNotifyStatePair(FAnimNotifyProTimeline& Timeline, const FAnimNotifyProEvent& Event)
+	{
+		const int32 PairIndex = Event.NotifyType != EAnimNotifyProType::Notify ? Timeline.GetEntry(Event).PairIndex : INDEX_NONE;
+		return Timeline.Notifies.IsValidIndex(PairIndex) ? &Timeline.Notifies[PairIndex] : nullptr;
+	}
 
 	/**
 	 * Handles historic notifies, triggering them before the start time if specified, or marking them as skipped.
-	 * @param Notifies The array of notifies to handle.
-	 * @param NotifyStatePairs A map pairing begin and end events by NotifyId, to assist in handling end states.
+	 * @param Timeline The timeline whose notifies to handle.
+	 * Anything in the section before the position the clock starts from is historic.
 	 * @param bTriggerNotifiesBeforeStartTime Whether to trigger notifies before the start time.
-	 * @param StartTime The start time of the montage, used to determine which notifies are historic.
 	 * @param Interface The interface to use for broadcasting notify events.
 	 */
-	static void HandleHistoricNotifies(TArray<FAnimNotifyProEvent>& Notifies, const TMap<uint32, uint32>& NotifyStatePairs,
-		bool bTriggerNotifiesBeforeStartTime, float StartTime, IPlayMontageProInterface* Interface);
+	static void HandleHistoricNotifies(FAnimNotifyProTimeline& Timeline, bool bTriggerNotifiesBeforeStartTime, IPlayMontageProInterface* Interface);
+
+	/** @return How timelines that set up their timers now should wake up their notifies, from PlayMontagePro.ScheduleMode */
+	static EAnimNotifyProScheduleMode GetScheduleMode();
+
+	/** @return Whether PlayMontage nodes with custom time dilation enabled also poll it from the mesh's OnTickPose, from PlayMontagePro.PollTimeDilation */
+	static bool ShouldPollTimeDilation();
 
 	/**
-	 * Sets up timers for the notifies in the Notifies array, using the provided interface to create timer delegates.
-	 * @param Interface The interface to use for creating timer delegates.
+	 * Bind to decide how significant a mesh is when a montage starts on it.
+	 * Meshes below PlayMontagePro.Significance.Threshold skip the montage's non-critical Pro notifies for that play.
+	 * If unbound, meshes are fully significant unless PlayMontagePro.Significance.UseVisibility is enabled.
+	 */
+	static FPlayMontageProSignificanceDelegate SignificanceDelegate;
+
+	/** @return How significant the mesh is, in the range 0 to 1, from SignificanceDelegate or its visibility */
+	static float GetSignificance(const USkeletalMeshComponent* MeshComp);
+
+	/** @return True if the mesh is at or above PlayMontagePro.Significance.Threshold */
+	static bool IsSignificant(const USkeletalMeshComponent* MeshComp);
+
+	/**
+	 * Sets up timers for the notifies in the timeline's current section, bound to the events through generation checked handles.
+	 * With cursor scheduling only a single timer is armed for the next event that is due,
+	 * with tick scheduling no timer is armed and UPlayMontageProSubsystem wakes the timeline up instead.
+	 * @param Interface The PlayMontage node the timers are set up for.
 	 * @param World The world context to use for setting up timers.
-	 * @param Notifies The array of notifies to set up timers for.
+	 * @param Timeline The timeline to set up timers for.
 	 */
-	static void SetupNotifyTimers(IPlayMontageProInterface* Interface, const UWorld* World, TArray<FAnimNotifyProEvent>& Notifies);
+	static void SetupNotifyTimers(IPlayMontageProInterface* Interface, const UWorld* World, FAnimNotifyProTimeline& Timeline);
 
 	/**
-	 * Clears the timers for the notifies in the Notifies array.
+	 * Clears the timers for the notifies in the timeline.
 	 * @param World The world context to use for clearing timers.
-	 * @param Notifies The array of notifies to clear timers for.
+	 * @param Timeline The timeline to clear timers for.
+	 */
+	static void ClearNotifyTimers(const UWorld* World, FAnimNotifyProTimeline& Timeline);
+
+	/**
+	 * Advances the cursor past events that have already been handled and arms the cursor timer for the next pending event,
+	 * or schedules it with UPlayMontageProSubsystem when using tick scheduling. Clears the cursor timer if no events remain.
+	 * @param World The world context to use for arming the timer.
+	 * @param Timeline The timeline to arm, must be using cursor or tick scheduling.
 	 */
-	static void ClearNotifyTimers(const UWorld* World, TArray<FAnimNotifyProEvent>& Notifies);
+	static void ArmNotifyCursor(const UWorld* World, FAnimNotifyProTimeline& Timeline);
+
+	/**
+	 * Broadcasts every event that is due from the cursor onwards, then re-arms the cursor for the following event.
+	 * Called by UPlayMontageProSubsystem when the cursor timer fires or the timeline is due on its tick.
+	 * @param Interface The interface to use for broadcasting notify events.
+	 * @param World The world context used to determine which events are due.
+	 * @param Timeline The timeline to dispatch, must be using cursor or tick scheduling.
+	 */
+	static void DispatchDueNotifies(IPlayMontageProInterface* Interface, const UWorld* World, FAnimNotifyProTimeline& Timeline);
+
+	/**
+	 * Broadcasts every event in the current section that the clock has reached, in schedule order, when one of their legacy per-event timers fires.
+	 * Timers that expire in the same frame are coalesced into this single pass, the timers of the events it fires are cleared.
+	 * Like DispatchDueNotifies, first picks up play rate, position and CustomTimeDilation changes made directly on the montage or actor.
+	 * @param Interface The interface to use for broadcasting notify events.
+	 * @param World The world context used to determine which events are due.
+	 * @param Timeline The timeline to dispatch.
+	 * @param EventIndex Index of the event whose timer fired.
+	 */
+	static void DispatchDueTimerNotifies(IPlayMontageProInterface* Interface, const UWorld* World, FAnimNotifyProTimeline& Timeline, int32 EventIndex);
 
 	/**
 	 * Broadcasts a notify event using the provided interface.
-	 * @param Event The notify event to broadcast.
-	 * @param NotifyStatePair The paired notify event, e.g. end or start state of a notify state.
+	 * An end state broadcasts its begin state first if it hasn't fired yet.
+	 * @param Timeline The timeline that owns the event, used to resolve its pair and track what is still pending.
+	 * @param Event The notify event to broadcast, must belong to the timeline's Notifies.
 	 * @param Interface The interface to use for broadcasting the event.
+	 * @param Trigger Why the event is firing, passed to the notify's callback with its FAnimNotifyProContext.
 	 */
-	static void BroadcastNotifyEvent(FAnimNotifyProEvent& Event, FAnimNotifyProEvent* NotifyStatePair, IPlayMontageProInterface* Interface);
+	static void BroadcastNotifyEvent(FAnimNotifyProTimeline& Timeline, FAnimNotifyProEvent& Event, IPlayMontageProInterface* Interface,
+		EAnimNotifyProTrigger Trigger = EAnimNotifyProTrigger::Scheduled);
+
+	/**
+	 * Describes the timeline as the event fires, for the notify's callbacks.
+	 * @param Timeline The timeline that owns the event.
+	 * @param Event The event that is firing.
+	 * @param World The world the montage is playing in, used for the fire time. Falls back to the clock's last retime if null.
+	 * @param Trigger Why the event is firing.
+	 */
+	static FAnimNotifyProContext MakeNotifyContext(const FAnimNotifyProTimeline& Timeline, const FAnimNotifyProEvent& Event,
+		const UWorld* World, EAnimNotifyProTrigger Trigger);
+
+	/**
+	 * Describes the montage for a Pro notify triggered by the engine's notify system, on simulated proxies or in the editor preview.
+	 * @param MeshComp The mesh playing the montage.
+	 * @param Montage The montage the notify belongs to.
+	 * @param EventReference The engine's reference to the notify event, used for its scheduled time.
+	 * @param bEndState True if a notify state is ending, the scheduled time is then its end time.
+	 */
+	static FAnimNotifyProContext MakeLegacyNotifyContext(const USkeletalMeshComponent* MeshComp, const UAnimMontage* Montage,
+		const FAnimNotifyEventReference& EventReference, bool bEndState = false);
 
 	/**
 	 * Ensures that broadcast notify events are triggered for the specified event type.
+	 * Only visits the events still pending for the event type, so the cost doesn't grow with events that already fired.
+	 * Does nothing if the interface's timeline has not started or has been released.
 	 * @param EventType The type of event to ensure is broadcasted.
-	 * @param Notifies The array of notifies to check and broadcast.
-	 * @param NotifyStatePairs A map pairing begin and end events by NotifyId, to assist in broadcasting end states.
-	 * @param Interface The interface to use for broadcasting the events.
+	 * @param Interface The interface whose timeline to check, also used for broadcasting the events.
 	 */
-	static void EnsureBroadcastNotifyEvents(EAnimNotifyProEventType EventType, TArray<FAnimNotifyProEvent>& Notifies,
-		const TMap<uint32, uint32>& NotifyStatePairs, IPlayMontageProInterface* Interface);
+	static void EnsureBroadcastNotifyEvents(EAnimNotifyProEventType EventType, IPlayMontageProInterface* Interface);
 
 	/**
-	 * Handles time dilation for the montage, adjusting the TimeDilation factor and triggering notifies as needed.
-	 * Requires that the mesh component is ticking pose.
-	 * @param Interface The interface to use for broadcasting notify events.
+	 * Polls time dilation for the montage, adjusting the timeline's TimeDilation factor and retiming notifies as needed.
+	 * Also picks up play rate changes made with Montage_SetPlayRate and pauses made with Montage_Pause. Requires that the mesh component is ticking pose.
+	 * Only used when PlayMontagePro.PollTimeDilation is enabled, otherwise changes are pushed by SetActorCustomTimeDilation.
+	 * @param Interface The interface whose montage instance to poll the play rate from.
 	 * @param MeshComp The skinned mesh component associated with the montage.
-	 * @param TimeDilation The current time dilation factor to adjust.
-	 * @param Notifies The array of notifies to handle.
+	 * @param Timeline The timeline to retime.
 	 */
-	static void HandleTimeDilation(IPlayMontageProInterface* Interface, const USkinnedMeshComponent* MeshComp, float& TimeDilation, TArray<FAnimNotifyProEvent>& Notifies);
+	static void HandleTimeDilation(IPlayMontageProInterface* Interface, const USkinnedMeshComponent* MeshComp, FAnimNotifyProTimeline& Timeline);
+
+	/**
+	 * Changes the rate of the timeline's clock, which advances at PlayRate * TimeDilation montage seconds per world second.
+	 * Notify times are in montage time, so with cursor or tick scheduling only the next due time is re-armed.
+	 * A rate of zero or below stops the clock until the rate is changed again.
+	 * @param World The world context to use for re-arming timers.
+	 * @param Timeline The timeline to retime.
+	 * @param PlayRate The montage play rate.
+	 * @param TimeDilation The owning actor's custom time dilation.
+	 */
+	static void SetTimelineRate(const UWorld* World, FAnimNotifyProTimeline& Timeline, float PlayRate, float TimeDilation);
+
+	/**
+	 * Moves the timeline's clock to a new montage position without gathering the notifies again.
+	 * Binary searches the schedule for the position, then handles the events passed over like historic notifies and arms only the next one.
+	 * Seeking back within the section replays the events from the position, seeking into another section enters it fresh.
+	 * @param Interface The interface to use for broadcasting notify events.
+	 * @param World The world context to use for re-arming timers.
+	 * @param Timeline The timeline to seek.
+	 * @param Position The montage position to seek to.
+	 */
+	static void SeekTimeline(IPlayMontageProInterface* Interface, const UWorld* World, FAnimNotifyProTimeline& Timeline, float Position);
+
+	/**
+	 * Moves the timeline into the section the montage changed to, from OnMontageSectionChanged.
+	 * Cursor and tick scheduling follow section links and loops ahead of time, so this only seeks if the montage went elsewhere.
+	 * If the montage played to the end of the section, following its link or looping, the events it passed over fire before moving on.
+	 * Jumping out of the section early, e.g. with Montage_JumpToSection, drops the events left in it.
+	 * @param Interface The interface to use for broadcasting notify events.
+	 * @param World The world context to use for re-arming timers.
+	 * @param Timeline The timeline to move.
+	 * @param Position The montage position after the section change.
+	 * @param bLooped Whether the montage looped, from OnMontageSectionChanged.
+	 */
+	static void HandleSectionChange(IPlayMontageProInterface* Interface, const UWorld* World, FAnimNotifyProTimeline& Timeline, float Position,
+		bool bLooped);
+
+	/**
+	 * Stops or restarts the timeline's clock, keeping its reading so nothing is lost while paused.
+	 * With cursor or tick scheduling only the next due time is re-armed, per-notify timers are paused and keep their remaining time.
+	 * @param World The world context to use for re-arming timers.
+	 * @param Timeline The timeline to pause or resume.
+	 * @param bPaused Whether the montage is paused.
+	 */
+	static void SetTimelinePaused(const UWorld* World, FAnimNotifyProTimeline& Timeline, bool bPaused);
+
+	/** @return The active montage instance for the interface's montage on its mesh, or nullptr if it is not playing */
+	static FAnimMontageInstance* GetMontageInstance(const IPlayMontageProInterface* Interface);
 };
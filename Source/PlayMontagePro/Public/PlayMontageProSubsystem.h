@@ -0,0 +1,293 @@
+// Copyright (c) Jared Taylor
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayMontageTypes.h"
+#include "Containers/ChunkedArray.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PlayMontageProSubsystem.generated.h"
+
+class AActor;
+class IPlayMontageProInterface;
+class UAnimMontage;
+class UAnimNotifyStatePro;
+class UPlayMontageProCallbackProxy;
+class USkeletalMeshComponent;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnPlayMontageProTimeDilationChanged, AActor* /*Actor*/, float /*TimeDilation*/);
+
+/** Next due time of a timeline driven by the subsystem tick, ordered so the heap top is the earliest */
+struct FAnimNotifyProDueTimeline
+{
+	double DueTime = 0.0;
+	int32 PoolIndex = INDEX_NONE;
+	uint32 Generation = 0;
+
+	bool operator<(const FAnimNotifyProDueTimeline& Other) const { return DueTime < Other.DueTime; }
+};
+
+/** Event deferred by the dispatch budget, ordered so the heap top is the longest waiting */
+struct FAnimNotifyProDeferredNotify
+{
+	int32 PoolIndex = INDEX_NONE;
+	uint32 Generation = 0;
+	int32 EventIndex = INDEX_NONE;
+
+	/** World time the event was due and deferred at */
+	double DeferredTime = 0.0;
+
+	/** Longest waiting first, only non-critical events are deferred */
+	bool operator<(const FAnimNotifyProDeferredNotify& Other) const
+	{
+		return DeferredTime < Other.DeferredTime;
+	}
+};
+
+/** An active notify state that ticks, batched into the subsystem's tick */
+struct FAnimNotifyProTickWindow
+{
+	/** Kept alive by the timeline's montage, only read while the timeline's generation matches */
+	UAnimNotifyStatePro* NotifyState = nullptr;
+
+	int32 PoolIndex = INDEX_NONE;
+	uint32 Generation = 0;
+	int32 BeginIndex = INDEX_NONE;
+	int32 EndIndex = INDEX_NONE;
+
+	/** Montage time elapsed since the last tick */
+	float Elapsed = 0.f;
+
+	/** Frames since the last tick */
+	int32 Frames = 0;
+
+	/** Frame the window opened in, it first ticks the frame after */
+	uint64 OpenedFrame = 0;
+};
+
+/**
+ * Owns every active Pro notify timeline in the world in a pool, the PlayMontage nodes only hold an FAnimNotifyProTimelineHandle.
+ * Timelines using EAnimNotifyProScheduleMode::Tick are advanced from this subsystem's single tick,
+ * which pops a min-heap of next-due times and dispatches every timeline that is due.
+ * The pool is chunked so timelines keep their address while callbacks acquire new ones mid-dispatch.
+ * Also pools the Blueprint PlayMontagePro node's callback proxies, which are reused once their montage has ended.
+ * Notify states with a TickInterval are ticked from the same tick, every active state in the world is iterated in one contiguous array.
+ * With PlayMontagePro.DispatchBudget.Ms set, notifies due once the frame's budget is spent wait in a priority queue drained by the tick.
+ */
+UCLASS()
+class PLAYMONTAGEPRO_API UPlayMontageProSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** @return The subsystem for the world, or nullptr if the world doesn't have one */
+	static UPlayMontageProSubsystem* Get(const UWorld* World);
+
+	/**
+	 * Acquires a timeline from the world's pool, releasing the timeline previously held by the handle.
+	 * @param World The world the montage is playing in.
+	 * @param Owner The PlayMontage node, events are only dispatched while it is alive.
+	 * @param Interface The owner's interface, used for broadcasting notify events.
+	 * @param OutHandle Receives the handle to the timeline.
+	 * @param TimeDilationActor If set, the timeline's clock follows this actor's custom time dilation.
+	 * @param Montage If set, a free slot that last played the montage is preferred, so its events are reused rather than gathered again.
+	 * @return The timeline, or nullptr if the world doesn't have a subsystem.
+	 */
+	static FAnimNotifyProTimeline* AcquireTimeline(const UWorld* World, UObject* Owner, IPlayMontageProInterface* Interface,
+		FAnimNotifyProTimelineHandle& OutHandle, AActor* TimeDilationActor = nullptr, const UAnimMontage* Montage = nullptr);
+
+	/** Clears the timeline's timers and returns it to the pool, then resets the handle */
+	static void ReleaseTimeline(FAnimNotifyProTimelineHandle& Handle);
+
+	/** @return The timeline, or nullptr if the handle has been released */
+	FAnimNotifyProTimeline* GetTimeline(const FAnimNotifyProTimelineHandle& Handle);
+
+	/** @return The event, or nullptr if its timeline has been released, even if the slot has since replayed the same montage, or its events have been gathered again */
+	FAnimNotifyProEvent* GetEvent(const FAnimNotifyProEventHandle& Handle);
+
+	/** @return A timer delegate that broadcasts the timeline's event through a generation checked handle */
+	FTimerDelegate CreateNotifyTimerDelegate(const FAnimNotifyProTimeline& Timeline, int32 EventIndex);
+
+	/** Calls the function for every acquired timeline */
+	void ForEachActiveTimeline(TFunctionRef<void(FAnimNotifyProTimeline&)> Function);
+
+	/** Calls the function for every acquired timeline whose owner plays its montage on the mesh, without visiting the rest of the pool */
+	void ForEachMeshTimeline(const USkeletalMeshComponent* Mesh, TFunctionRef<void(FAnimNotifyProTimeline&)> Function);
+
+	/**
+	 * Retimes every timeline following the actor's custom time dilation, then broadcasts OnTimeDilationChanged.
+	 * Call after changing AActor::CustomTimeDilation, or use UPlayMontageProStatics::SetActorCustomTimeDilation which does both.
+	 */
+	void NotifyTimeDilationChanged(AActor* Actor);
+
+	/** Broadcast once whenever NotifyTimeDilationChanged is called */
+	FOnPlayMontageProTimeDilationChanged OnTimeDilationChanged;
+
+	/** Wakes the timeline up from the tick at the given world time, replacing any previously scheduled time */
+	void ScheduleTimeline(FAnimNotifyProTimeline& Timeline, double DueTime);
+
+	/**
+	 * Starts ticking a notify state whose begin event has fired, until its end event fires or the timeline is released.
+	 * Does nothing if the notify state doesn't want to tick, or is already ticking for the event.
+	 */
+	void OpenTickWindow(const FAnimNotifyProTimeline& Timeline, int32 BeginIndex);
+
+	/** @return Number of notify states currently ticking */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int32 GetNumTickWindows() const { return TickWindows.Num(); }
+
+	/** @return True if PlayMontagePro.DispatchBudget.Ms is set, dispatching then times its callbacks against it */
+	static bool HasDispatchBudget();
+
+	/**
+	 * Defers the event to a later frame if this frame's dispatch budget is spent.
+	 * Events with EnsureTriggerNotify set or marked critical always fire straight away.
+	 * @return True if the event was deferred.
+	 */
+	bool TryDeferNotify(FAnimNotifyProTimeline& Timeline, int32 EventIndex);
+
+	/** Counts time spent in notify callbacks against this frame's dispatch budget */
+	void AddDispatchTime(double Seconds);
+
+	/** @return Number of notifies waiting for a later frame's dispatch budget */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int32 GetNumDeferredNotifies() const { return DeferredNotifies.Num(); }
+
+	/** @return Number of notifies that have been deferred by the dispatch budget */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int32 GetDeferredNotifyCount() const { return DeferredNotifyCount; }
+
+	/** @return Number of deferred notifies that never fired because their timeline was released first */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int32 GetDroppedDeferredNotifyCount() const { return DroppedDeferredNotifyCount; }
+
+	/** @return Average latency added to deferred notifies once they fired, in milliseconds of world time */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	float GetAverageDeferredLatencyMs() const { return DrainedNotifyCount > 0 ? static_cast<float>(DeferredLatencySeconds * 1000.0 / DrainedNotifyCount) : 0.f; }
+
+	/** @return Longest latency added to a deferred notify, in milliseconds of world time */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	float GetMaxDeferredLatencyMs() const { return static_cast<float>(MaxDeferredLatencySeconds * 1000.0); }
+
+	/** @return A callback proxy from the world's pool, or a new one if the pool is empty or the world doesn't have a subsystem */
+	static UPlayMontageProCallbackProxy* AcquireProxy(const UWorld* World);
+
+	/**
+	 * Returns a proxy whose montage has ended to the pool, unless the pool is full.
+	 * The proxy is only reset and reused from the next frame, so the callbacks that ended its montage can finish with it,
+	 * and only if no live object is bound to its delegates or references it. Otherwise it is left for GC to collect.
+	 */
+	void ReleaseProxy(UPlayMontageProCallbackProxy* Proxy);
+
+	/** @return Number of callback proxies waiting in the pool */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int32 GetProxyPoolSize() const { return FreeProxies.Num(); }
+
+	/** @return Number of callback proxies that were reused from the pool */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int32 GetProxyPoolHits() const { return ProxyPoolHits; }
+
+	/** @return Number of callback proxies that had to be created because the pool was empty */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int32 GetProxyPoolMisses() const { return ProxyPoolMisses; }
+
+	/** @return Number of released callback proxies that weren't pooled because something still listened to or referenced them */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int32 GetProxyPoolRejections() const { return ProxyPoolRejections; }
+
+	/** Adds to the live count of armed notify timers, called when a timer is armed, cleared or fires */
+	void AddArmedTimers(int32 Delta);
+
+	/** @return Number of notify timers currently armed, per event or per timeline cursor */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int32 GetNumArmedTimers() const { return NumArmedTimers; }
+
+	/** @return Number of timelines currently acquired */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int32 GetNumActiveTimelines() const { return NumActiveTimelines; }
+
+	/** @return Number of timelines allocated by the pool, active or free */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	int32 GetTimelinePoolSize() const { return Timelines.Num(); }
+
+	/** @return Time spent in the last tick, in milliseconds */
+	UFUNCTION(BlueprintPure, Category=Animation)
+	float GetLastTickTimeMs() const { return LastTickTimeMs; }
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override
+	{
+		return DueTimelines.Num() > 0 || TickWindows.Num() > 0 || DeferredNotifies.Num() > 0 || PendingProxies.Num() > 0;
+	}
+	virtual TStatId GetStatId() const override;
+	// ~FTickableGameObject
+
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+protected:
+	void OnCursorTimer(int32 PoolIndex);
+	void OnNotifyTimer(FAnimNotifyProEventHandle Handle);
+	void DispatchTimeline(FAnimNotifyProTimeline& Timeline);
+	void TickNotifyStates(float DeltaTime);
+	void DrainDeferredNotifies();
+	void PoolPendingProxies();
+
+	/** @return True if this frame's dispatch budget has been spent */
+	bool IsOverDispatchBudget();
+	void FreeTimeline(FAnimNotifyProTimeline& Timeline);
+
+	/** @return True if the entry is still the timeline's scheduled due time, rather than left behind by re-scheduling or releasing it */
+	bool IsDueTimelineLive(const FAnimNotifyProDueTimeline& Due) const;
+
+	/** Drops the stale entries from DueTimelines and restores the heap */
+	void CompactDueTimelines();
+
+	/** Pooled timelines, released slots keep their events so the next play of the same montage reuses them */
+	TChunkedArray<FAnimNotifyProTimeline> Timelines;
+	TArray<int32> FreeIndices;
+
+	/** Pool indices of the timelines following each actor's custom time dilation */
+	TMap<TObjectKey<AActor>, TArray<int32, TInlineAllocator<2>>> TimeDilationFollowers;
+
+	/** Pool indices of the timelines playing a montage on each mesh */
+	TMap<TObjectKey<USkeletalMeshComponent>, TArray<int32, TInlineAllocator<2>>> MeshTimelines;
+
+	/** Min-heap of timelines waiting on the tick, entries made stale by re-scheduling or releasing are skipped when popped, or compacted once they outnumber the live ones */
+	TArray<FAnimNotifyProDueTimeline> DueTimelines;
+
+	/** Notify states that tick, windows are removed lazily once their end event fires or their timeline is released */
+	TArray<FAnimNotifyProTickWindow> TickWindows;
+
+	/** Heap of notifies deferred by the dispatch budget, entries whose timeline was released or event was replayed are skipped when popped */
+	TArray<FAnimNotifyProDeferredNotify> DeferredNotifies;
+
+	/** Frame the dispatch budget was last spent in, and how much of it */
+	uint64 DispatchBudgetFrame = 0;
+	double DispatchBudgetSpent = 0.0;
+
+	int32 DeferredNotifyCount = 0;
+	int32 DrainedNotifyCount = 0;
+	int32 DroppedDeferredNotifyCount = 0;
+	double DeferredLatencySeconds = 0.0;
+	double MaxDeferredLatencySeconds = 0.0;
+
+	int32 NumActiveTimelines = 0;
+	int32 NumArmedTimers = 0;
+	float LastTickTimeMs = 0.f;
+
+	/** Callback proxies whose montage has ended, reset and waiting to be reused */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UPlayMontageProCallbackProxy>> FreeProxies;
+
+	/** Callback proxies released since PendingProxiesFrame, waiting for a later frame to be checked, reset and pooled */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UPlayMontageProCallbackProxy>> PendingProxies;
+	uint64 PendingProxiesFrame = 0;
+
+	int32 ProxyPoolHits = 0;
+	int32 ProxyPoolMisses = 0;
+	int32 ProxyPoolRejections = 0;
+};
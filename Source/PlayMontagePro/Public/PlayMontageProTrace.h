@@ -0,0 +1,71 @@
+// Copyright (c) Jared Taylor
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+
+class UAnimMontage;
+struct FAnimNotifyProSchedule;
+struct FAnimNotifyProTimeline;
+
+#if !defined(PLAYMONTAGEPRO_TRACE_ENABLED)
+#define PLAYMONTAGEPRO_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+#endif
+
+/** What happened to a Pro notify event, written to PlayMontageProChannel, each event ends with exactly one of Fired, Ensured, Skipped or Cancelled */
+enum class EPlayMontageProTraceEvent : uint8
+{
+	Armed,		// The event was first scheduled, re-arming it after a retime or seek isn't traced, Reason is the EAnimNotifyProScheduleMode
+	Fired,		// The event was broadcast, Reason is the EAnimNotifyProTrigger
+	Ensured,	// The montage aborted before the event was reached and it was broadcast anyway, Reason is the EAnimNotifyProEventType it was ensured for
+	Skipped,	// Reason 0: the event was before the start or seek position and bTriggerNotifiesBeforeStartTime is disabled, 1: its timeline was released while the dispatch budget deferred it
+	Cancelled,	// The timeline was released before the event fired
+};
+
+/** Why a timeline's clock was rebased, written to PlayMontageProChannel */
+enum class EPlayMontageProTraceRetime : uint8
+{
+	PlayRate,
+	TimeDilation,
+	Paused,
+	Resumed,
+	Seek,
+};
+
+#if PLAYMONTAGEPRO_TRACE_ENABLED
+
+/**
+ * Structured Pro notify lifecycle events for Unreal Insights, enable with -trace=default,PlayMontagePro.
+ * Montages and owning actors are identified by their FObjectTrace ids, so events line up with Gameplay Insights' object tracks.
+ */
+UE_TRACE_CHANNEL_EXTERN(PlayMontageProChannel, PLAYMONTAGEPRO_API);
+
+struct PLAYMONTAGEPRO_API FPlayMontageProTrace
+{
+	static void OutputScheduleBuilt(const UAnimMontage* Montage, const FAnimNotifyProSchedule& Schedule, bool bBaked);
+	static void OutputNotifyEvent(EPlayMontageProTraceEvent Type, const FAnimNotifyProTimeline& Timeline, int32 EventIndex, uint8 Reason);
+	static void OutputRetimed(EPlayMontageProTraceRetime Reason, const FAnimNotifyProTimeline& Timeline, float OldRate);
+	static void OutputCancelled(const FAnimNotifyProTimeline& Timeline);
+};
+
+#define TRACE_PLAYMONTAGEPRO_SCHEDULE_BUILT(Montage, Schedule, bBaked) \
+	FPlayMontageProTrace::OutputScheduleBuilt(Montage, Schedule, bBaked)
+
+#define TRACE_PLAYMONTAGEPRO_NOTIFY(Type, Timeline, EventIndex, Reason) \
+	FPlayMontageProTrace::OutputNotifyEvent(EPlayMontageProTraceEvent::Type, Timeline, EventIndex, static_cast<uint8>(Reason))
+
+#define TRACE_PLAYMONTAGEPRO_RETIMED(Reason, Timeline, OldRate) \
+	FPlayMontageProTrace::OutputRetimed(EPlayMontageProTraceRetime::Reason, Timeline, OldRate)
+
+#define TRACE_PLAYMONTAGEPRO_CANCELLED(Timeline) \
+	FPlayMontageProTrace::OutputCancelled(Timeline)
+
+#else
+
+#define TRACE_PLAYMONTAGEPRO_SCHEDULE_BUILT(Montage, Schedule, bBaked)
+#define TRACE_PLAYMONTAGEPRO_NOTIFY(Type, Timeline, EventIndex, Reason)
+#define TRACE_PLAYMONTAGEPRO_RETIMED(Reason, Timeline, OldRate)
+#define TRACE_PLAYMONTAGEPRO_CANCELLED(Timeline)
+
+#endif
@@ -5,12 +5,17 @@
 #include "CoreMinimal.h"
 #include "Engine/TimerHandle.h"
 #include "TimerManager.h"
+#include "UObject/ObjectKey.h"
 #include "PlayMontageTypes.generated.h"
 
+class AActor;
 class UAbilityTask;
 class UAnimNotifyStatePro;
 class UAnimNotifyPro;
 class UAnimMontage;
+class UPlayMontageProSubsystem;
+class IPlayMontageProInterface;
+class USkeletalMeshComponent;
 
 /**
  * Legacy behavior for anim notifies on simulated proxies.
@@ -25,6 +30,19 @@ enum class EAnimNotifyLegacyType : uint8
 	Disabled		UMETA(ToolTip="Notify will not be triggered on simulated proxies, only on authority and local clients"),
 };
 
+/**
+ * How often an active UAnimNotifyStatePro receives OnNotifyTick.
+ * Every ticking notify state in the world is batched into UPlayMontageProSubsystem's tick.
+ */
+UENUM(BlueprintType)
+enum class EAnimNotifyProTickInterval : uint8
+{
+	None			UMETA(ToolTip="The notify state doesn't tick"),
+	EveryFrame		UMETA(ToolTip="Ticks every frame while the notify state is active"),
+	FixedRate		UMETA(ToolTip="Ticks at most TickRate times per second of montage time, with the time elapsed since its last tick"),
+	EveryNFrames	UMETA(ToolTip="Ticks every TickFrames frames, with the time elapsed since its last tick"),
+};
+
 /**
  * Bitmask for anim notify events, used to determine which events should trigger callbacks.
  * Used by UAnimNotifyPro and UAnimNotifyStatePro.
@@ -42,8 +60,9 @@ ENUM_CLASS_FLAGS(EAnimNotifyProEventType)
 
 /**
  * Type of anim notify event, used to determine which callback to use.
- * Used by FAnimNotifyProEvent.
+ * Used by FAnimNotifyProEvent and FAnimNotifyProScheduleEntry.
  */
+UENUM()
 enum class EAnimNotifyProType : uint8
 {
 	Notify,
@@ -52,85 +71,236 @@ enum class EAnimNotifyProType : uint8
 };
 
 /**
- * Struct representing an anim notify event.
- * Contains information about the notify, such as its ID, time, and whether it has been broadcast.
- * Used by PlayMontagePro to handle anim notifies and notify states.
+ * Why a Pro notify fired, passed to its callbacks with FAnimNotifyProContext.
+ */
+UENUM()
+enum class EAnimNotifyProTrigger : uint8
+{
+	Scheduled,	// The clock reached the event
+	Historic,	// The event is before the position the montage started or seeked from, and bTriggerNotifiesBeforeStartTime is enabled
+	Ensured,	// The montage blended out, ended or was cancelled before reaching the event, see EnsureTriggerNotify
+	Legacy,		// Triggered by the engine's notify system, on simulated proxies or in the editor preview
+};
+
+/**
+ * Describes the montage when a Pro notify fires, built on the stack and passed to the notify's callbacks.
+ * Saves handlers looking the montage instance up through the anim instance.
+ */
+struct PLAYMONTAGEPRO_API FAnimNotifyProContext
+{
+	/** Montage position the event was scheduled to fire at */
+	float ScheduledTime = 0.f;
+
+	/** Montage position on the Pro notify clock when the event fired */
+	float MontagePosition = 0.f;
+
+	/** How far past its scheduled time the event fired, in montage seconds */
+	float Lateness = 0.f;
+
+	/** Montage seconds the clock advances per world second, the play rate scaled by custom time dilation, zero while paused */
+	float EffectiveRate = 1.f;
+
+	/** World time the event fired at */
+	double FireWorldTime = 0.0;
+
+	/** Montage section the clock was in */
+	FName SectionName = NAME_None;
+	int32 SectionIndex = INDEX_NONE;
+
+	/** FAnimMontageInstance::GetInstanceID of the montage when it started, INDEX_NONE if unknown */
+	int32 MontageInstanceID = INDEX_NONE;
+
+	/** Why the event fired */
+	EAnimNotifyProTrigger Trigger = EAnimNotifyProTrigger::Scheduled;
+
+	/** @return True if the event fired without the clock reaching it, from an ensure or historic trigger */
+	bool IsOutOfBand() const { return Trigger == EAnimNotifyProTrigger::Historic || Trigger == EAnimNotifyProTrigger::Ensured; }
+};
+
+/**
+ * Net contexts a Pro notify doesn't fire in, from its bTriggerOnDedicatedServer and SimulatedProxyBehavior.
+ * Computed once when the montage's schedule is built, events are filtered out when gathered by a montage playing in one of these contexts.
+ */
+UENUM(meta = (Bitflags))
+enum class EAnimNotifyProNetFilter : uint8
+{
+	None				= 0,
+	DedicatedServer		= 1 << 0,	// Skipped on dedicated servers
+	SimulatedProxy		= 1 << 1,	// Left to the legacy notify system on simulated proxies
+};
+ENUM_CLASS_FLAGS(EAnimNotifyProNetFilter)
+
+/**
+ * Single entry in a montage's Pro notify schedule.
+ * Times are in montage space, the start offset and time scale are applied per play when the entry becomes an event.
  */
 USTRUCT()
-struct PLAYMONTAGEPRO_API FAnimNotifyProEvent
+struct PLAYMONTAGEPRO_API FAnimNotifyProScheduleEntry
 {
 	GENERATED_BODY()
-	
-	FAnimNotifyProEvent(const UObject* InTaskOwner = nullptr, uint32 InNotifyId = 0, int32 InEnsureTriggerNotify = 0, 
-		EAnimNotifyProType InNotifyType = EAnimNotifyProType::Notify, float InTime = 0.f, float InDuration = 0.f)
-		: TaskOwner(InTaskOwner)
-		, EnsureTriggerNotify(InEnsureTriggerNotify)
-		, bEnsureEndStateIfTriggered(true)
-		, Time(InTime)
-		, Duration(InDuration)
-		, NotifyId(InNotifyId)
-		, bHasBroadcast(false)
-		, bIsEndState(false)
-		, bNotifySkipped(false)
-		, NotifyType(InNotifyType)
-	{}
 
+	/** Notify object, valid when NotifyType is Notify */
 	UPROPERTY()
-	TWeakObjectPtr<const UObject> TaskOwner;
-	
-	/** Bitmask for ensuring that notifies are triggered if the montage aborts before they're reached when aborted due to these conditions */
+	TObjectPtr<UAnimNotifyPro> Notify = nullptr;
+
+	/** Notify state object, valid when NotifyType is NotifyStateBegin or NotifyStateEnd */
 	UPROPERTY()
-	int32 EnsureTriggerNotify;
+	TObjectPtr<UAnimNotifyStatePro> NotifyState = nullptr;
 
-	/** If true, the end state will be ensured if the notify was triggered */
+	/** Montage position at which the event triggers */
 	UPROPERTY()
-	bool bEnsureEndStateIfTriggered;
+	float Time = 0.f;
 
-	/** Time at which the notify should be triggered */
+	/** Duration of the notify state in montage time, zero for notifies and end states */
 	UPROPERTY()
-	float Time;
-	
-	/** Duration of the notify, used for notify states */
+	float Duration = 0.f;
+
+	/** Bitmask copied from the notify, see EAnimNotifyProEventType */
 	UPROPERTY()
-	float Duration;
+	int32 EnsureTriggerNotify = 0;
 
-	/** Unique ID for the notify, used to identify it in the list of notifies */
+	/** Index of the paired begin or end entry in FAnimNotifyProSchedule::Entries, INDEX_NONE for notifies */
 	UPROPERTY()
-	uint32 NotifyId;
+	int32 PairIndex = INDEX_NONE;
 
-	/** Whether the notify has been broadcasted */
+	/** Index of the source event in UAnimMontage::Notifies */
 	UPROPERTY()
-	bool bHasBroadcast;
+	int32 NotifyIndex = INDEX_NONE;
 
-	/** Whether this notify is an end state notify, used for notify states */
+	/** Net contexts the notify doesn't fire in */
 	UPROPERTY()
-	bool bIsEndState;
+	EAnimNotifyProNetFilter NetFilter = EAnimNotifyProNetFilter::None;
 
-	/** Whether the notify was skipped due to start position, used to determine if the notify should be broadcasted */
+	/** Chance the notify triggers each play, from FAnimNotifyEvent::NotifyTriggerChance */
 	UPROPERTY()
-	bool bNotifySkipped;
+	float TriggerChance = 1.f;
 
-	/** Type of the notify, used to determine which callback to use */
-	EAnimNotifyProType NotifyType;
+	/** The notify is filtered out when the mesh's predicted LOD is at or above this, INDEX_NONE if it isn't filtered by LOD */
+	UPROPERTY()
+	int32 FilterLOD = INDEX_NONE;
 
-	/** Timer handle for the notify */
-	FTimerHandle Timer;
+	/** If false the notify is filtered out when the mesh isn't significant, unless it has EnsureTriggerNotify set */
+	UPROPERTY()
+	bool bCritical = true;
+
+	UPROPERTY()
+	EAnimNotifyProType NotifyType = EAnimNotifyProType::Notify;
+};
+
+/**
+ * Range of FAnimNotifyProSchedule::Entries belonging to a single montage section.
+ */
+USTRUCT()
+struct PLAYMONTAGEPRO_API FAnimNotifyProScheduleSection
+{
+	GENERATED_BODY()
 
-	/** Delegate to call when the timer expires */
-	FTimerDelegate TimerDelegate;
+	UPROPERTY()
+	int32 FirstEntry = 0;
 
-	/** Weak pointer to the notify object, used to call the notify callback */
 	UPROPERTY()
-	TObjectPtr<UAnimNotifyPro> Notify;
+	int32 NumEntries = 0;
+};
+
+/**
+ * Immutable, time-sorted and section-bucketed list of the Pro notifies on a montage.
+ * Built once per montage and shared by every instance that plays it.
+ * @see UPlayMontageProScheduleCache
+ */
+USTRUCT()
+struct PLAYMONTAGEPRO_API FAnimNotifyProSchedule
+{
+	GENERATED_BODY()
 
-	/** Weak pointer to the notify state object, used to call the notify state callbacks */
+	/** Entries for every section, sorted by time within each section */
 	UPROPERTY()
-	TObjectPtr<UAnimNotifyStatePro> NotifyState;
+	TArray<FAnimNotifyProScheduleEntry> Entries;
 
-	/** Clears the timer and delegate, used to clean up the notify when it is no longer needed */
+	/** Entry range for each section, indexed by montage section index */
+	UPROPERTY()
+	TArray<FAnimNotifyProScheduleSection> Sections;
+
+	/** Union of every entry's NetFilter, gathering only filters events if any entry has one */
+	UPROPERTY()
+	EAnimNotifyProNetFilter NetFilters = EAnimNotifyProNetFilter::None;
+
+	/** Whether any entry has a trigger chance or LOD filter, gathering only rolls or checks the LOD if so */
+	UPROPERTY()
+	bool bHasTriggerFilters = false;
+
+	/** Whether any entry could be filtered out by the mesh's significance, gathering only asks for it if so */
+	UPROPERTY()
+	bool bHasSignificanceFilters = false;
+
+	/** @return The entries that trigger within the section, or an empty view if the section is invalid */
+	TConstArrayView<FAnimNotifyProScheduleEntry> GetSectionEntries(int32 SectionIndex) const
+	{
+		if (!Sections.IsValidIndex(SectionIndex))
+		{
+			return {};
+		}
+		const FAnimNotifyProScheduleSection& Section = Sections[SectionIndex];
+		return MakeArrayView(Entries.GetData() + Section.FirstEntry, Section.NumEntries);
+	}
+
+	bool IsEmpty() const { return Entries.Num() == 0; }
+};
+
+/**
+ * Struct representing an anim notify event.
+ * Only holds the per-play state of a FAnimNotifyProScheduleEntry, the entry at the same index in the timeline's schedule
+ * has the notify, duration, pair and ensure flags, and the timeline has the owner, so the event stays small and isn't walked by the GC.
+ * Used by PlayMontagePro to handle anim notifies and notify states.
+ */
+struct PLAYMONTAGEPRO_API FAnimNotifyProEvent
+{
+	FAnimNotifyProEvent(uint32 InNotifyId = 0, EAnimNotifyProType InNotifyType = EAnimNotifyProType::Notify, float InTime = 0.f)
+		: NotifyId(InNotifyId)
+		, Time(InTime)
+		, NotifyType(InNotifyType)
+		, bHasBroadcast(false)
+		, bIsEndState(InNotifyType == EAnimNotifyProType::NotifyStateEnd)
+		, bNotifySkipped(false)
+		, bFiltered(false)
+		, bDeferred(false)
+		, bArmed(false)
+	{}
+
+	/** Timer handle for the notify, only armed by EAnimNotifyProScheduleMode::Timers */
+	FTimerHandle Timer;
+
+	/** Unique ID for the notify, used to identify it in the list of notifies */
+	uint32 NotifyId;
+
+	/** Montage position at which the notify should be triggered, copied from the schedule entry so searches stay within the event array */
+	float Time;
+
+	/** Type of the notify, used to determine which callback to use */
+	EAnimNotifyProType NotifyType;
+
+	/** Whether the notify has been broadcasted */
+	uint8 bHasBroadcast : 1;
+
+	/** Whether this notify is an end state notify, used for notify states */
+	uint8 bIsEndState : 1;
+
+	/** Whether the notify was skipped due to start position, used to determine if the notify should be broadcasted */
+	uint8 bNotifySkipped : 1;
+
+	/** Whether the notify can't fire where the montage is playing, it is never armed, broadcast or ensured for the rest of the play */
+	uint8 bFiltered : 1;
+
+	/** Whether the notify is waiting in UPlayMontageProSubsystem's deferred queue because the frame's dispatch budget was spent */
+	uint8 bDeferred : 1;
+
+	/** Whether the event has been scheduled since it was last reset, re-arming it after a retime or seek isn't traced again */
+	uint8 bArmed : 1;
+
+	/** Forgets the timer once it has fired or been cleared */
 	void ClearTimers();
 
-	bool IsValidEvent() const;
+	/** @return True if the event was gathered from a schedule */
+	bool IsValidEvent() const { return NotifyId > 0; }
 
 	bool operator==(const FAnimNotifyProEvent& Other) const
 	{
@@ -145,11 +315,205 @@ struct PLAYMONTAGEPRO_API FAnimNotifyProEvent
 	uint32 GetTypeHash() const { return NotifyId; }
 };
 
+static_assert(sizeof(FAnimNotifyProEvent) <= 24, "FAnimNotifyProEvent is allocated for every notify of every playing montage, keep it compact");
+
 inline uint32 GetTypeHash(const FAnimNotifyProEvent& NotifyProEvent)
 {
 	return NotifyProEvent.GetTypeHash();
 }
 
+/** Events of a timeline, montages with up to 16 Pro notifies store them inline rather than on the heap */
+using FAnimNotifyProEventArray = TArray<FAnimNotifyProEvent, TInlineAllocator<16>>;
+
+/**
+ * How the events of a timeline are woken up when they are due.
+ * Selected by PlayMontagePro.ScheduleMode when the timers are set up.
+ */
+UENUM()
+enum class EAnimNotifyProScheduleMode : uint8
+{
+	Timers,		// One FTimerManager timer per event
+	Cursor,		// A single FTimerManager timer, armed for the next due event
+	Tick,		// No timers, the next due event is woken up by UPlayMontageProSubsystem's tick
+};
+
+/**
+ * Per-instance notify state for a playing montage, shared between the different PlayMontage nodes.
+ * Holds the events gathered for the whole montage and the state used to schedule those in the current section.
+ * Owned by UPlayMontageProSubsystem's pool, the PlayMontage nodes only hold an FAnimNotifyProTimelineHandle.
+ */
+USTRUCT()
+struct PLAYMONTAGEPRO_API FAnimNotifyProTimeline
+{
+	GENERATED_BODY()
+
+	/** Events for every section, laid out like the schedule's entries so each section is sorted by time */
+	FAnimNotifyProEventArray Notifies;
+
+	/** Schedule the events were gathered from, they are only gathered again if the montage's schedule is rebuilt */
+	TSharedPtr<const FAnimNotifyProSchedule> Schedule;
+
+	/** Montage the events were gathered from, referenced by the subsystem so the notifies instanced within it stay alive */
+	TObjectPtr<UAnimMontage> Montage = nullptr;
+
+	/** Montage the events were last gathered from, kept once the slot is released so the next play of it prefers this slot */
+	TObjectKey<UAnimMontage> GatheredMontage;
+
+	/** Montage section the clock is in, only the events in [SectionBegin, SectionEnd) can fire or be ensured */
+	int32 SectionIndex = INDEX_NONE;
+	int32 SectionBegin = 0;
+	int32 SectionEnd = 0;
+
+	/** Montage position the current section ends at, where cursor and tick scheduling follow the montage into its next section */
+	float SectionEndTime = 0.f;
+
+	/** Whether the cursor followed a section link or loop that the montage hasn't reported through OnMontageSectionChanged yet */
+	bool bAwaitingSectionChange = false;
+
+	/** Whether events before the position the clock starts or seeks from are triggered rather than skipped */
+	bool bTriggerNotifiesBeforeStartTime = false;
+
+	/** FAnimMontageInstance::GetInstanceID of the montage, looked up once when gathered and passed to callbacks with FAnimNotifyProContext */
+	int32 MontageInstanceID = INDEX_NONE;
+
+	/** Seed the notify trigger chances are rolled from, set by the PlayMontage node before gathering so the server and predicting client agree */
+	uint32 TriggerSeed = 0;
+
+	/** Running counter used to assign each gathered event a unique NotifyId */
+	uint32 NotifyId = 0;
+
+	/** Bumped whenever Notifies is gathered again, so timers bound to events of a previous gather no longer resolve */
+	uint32 EventGeneration = 0;
+
+	/** Number of EAnimNotifyProEventType flags that events can be ensured for */
+	static constexpr int32 NumEnsureEventTypes = 4;
+
+	/** Per EAnimNotifyProEventType flag, the events that haven't fired yet and should be ensured for it, indexed like Notifies. Stored inline up to 128 events */
+	TBitArray<> PendingEnsure[NumEnsureEventTypes];
+
+	/** End states whose begin state has fired but that haven't fired themselves, indexed like Notifies */
+	TBitArray<> PendingEndStates;
+
+	/** The PlayMontage node that acquired this timeline, events are only dispatched while it is alive */
+	TWeakObjectPtr<UObject> Owner;
+
+	/** Owner's interface, only dereferenced while Owner is valid */
+	IPlayMontageProInterface* Interface = nullptr;
+
+	/** Montage play rate, the clock advances at PlayRate * TimeDilation montage seconds per world second */
+	float PlayRate = 1.f;
+
+	/** Owning actor's custom time dilation */
+	float TimeDilation = 1.f;
+
+	/** Actor whose custom time dilation the clock follows, if enabled */
+	TObjectKey<AActor> TimeDilationActor;
+
+	/** Mesh the owner plays the montage on when it was acquired, the montage controls in UPlayMontageProStatics look the timeline up by it */
+	TObjectKey<USkeletalMeshComponent> Mesh;
+
+	/** Whether the montage is paused, which stops the clock without losing its reading */
+	bool bPaused = false;
+
+	/** Montage position on the clock when it was last rebased */
+	float ClockBase = 0.f;
+
+	/** World time the clock was last rebased at */
+	double ClockWorldTime = 0.0;
+
+	/** How the events are woken up, fixed when the timers are set up */
+	EAnimNotifyProScheduleMode ScheduleMode = EAnimNotifyProScheduleMode::Timers;
+
+	/** What the events broadcast by EnsureBroadcastNotifyEvents are being ensured for, traced as the reason they were ensured */
+	EAnimNotifyProEventType EnsureEventType = EAnimNotifyProEventType::None;
+
+	/** Index of the next event to dispatch when using cursor or tick scheduling */
+	int32 Cursor = 0;
+
+	/** Single timer armed for the event at Cursor when using cursor scheduling */
+	FTimerHandle CursorTimer;
+
+	/** Delegate bound once by the subsystem and reused every time the cursor timer is armed */
+	FTimerDelegate CursorTimerDelegate;
+
+	/** World time the event at Cursor is due when using tick scheduling, negative if nothing is scheduled */
+	double NextDueTime = -1.0;
+
+	/** Bumped whenever the timers are cleared, so a dispatch can tell that a callback restarted or released the timeline */
+	uint32 Serial = 0;
+
+	/** Slot in the subsystem pool */
+	int32 PoolIndex = INDEX_NONE;
+
+	/** Bumped every time the slot is released, so stale handles no longer resolve */
+	uint32 Generation = 0;
+
+	/** Whether the slot is currently acquired */
+	bool bActive = false;
+
+	/** @return Index of the event in Notifies, which is also the index of its entry in the schedule */
+	int32 GetEventIndex(const FAnimNotifyProEvent& Event) const { return UE_PTRDIFF_TO_INT32(&Event - Notifies.GetData()); }
+
+	/** @return The schedule entry the event was gathered from */
+	const FAnimNotifyProScheduleEntry& GetEntry(int32 EventIndex) const { return Schedule->Entries[EventIndex]; }
+	const FAnimNotifyProScheduleEntry& GetEntry(const FAnimNotifyProEvent& Event) const { return GetEntry(GetEventIndex(Event)); }
+
+	/** @return The owner's interface, or nullptr if the owner is no longer alive */
+	IPlayMontageProInterface* GetInterface() const { return Owner.IsValid() ? Interface : nullptr; }
+
+	/** @return Montage seconds the clock advances per world second */
+	float GetClockRate() const { return bPaused ? 0.f : PlayRate * TimeDilation; }
+
+	/** @return Montage position on the clock at the given world time */
+	float GetClockTime(double WorldTime) const { return ClockBase + static_cast<float>(WorldTime - ClockWorldTime) * GetClockRate(); }
+
+	/** @return World time at which the clock reaches the montage position, or a negative value if the clock is stopped */
+	double GetWorldTimeAt(float ClockTime) const
+	{
+		const float ClockRate = GetClockRate();
+		return ClockRate > UE_KINDA_SMALL_NUMBER ? ClockWorldTime + FMath::Max(ClockTime - ClockBase, 0.f) / ClockRate : -1.0;
+	}
+
+	/** Restarts the clock from the given world time without changing its reading, must be called before changing the rate */
+	void RebaseClock(double WorldTime)
+	{
+		ClockBase = GetClockTime(WorldTime);
+		ClockWorldTime = WorldTime;
+	}
+
+	/** @return True if the events are dispatched in order from Cursor rather than by a timer each */
+	bool UsesCursor() const { return ScheduleMode != EAnimNotifyProScheduleMode::Timers; }
+};
+
+/**
+ * Generation checked handle to an event of a timeline in UPlayMontageProSubsystem's pool.
+ * Events are recycled with their timeline's slot, the handle resolves to nullptr once they are gathered again or the slot is released.
+ * Replaying the same montage in the slot reuses its events as they are, so the slot's generation is checked as well as theirs.
+ */
+struct PLAYMONTAGEPRO_API FAnimNotifyProEventHandle
+{
+	int32 TimelineIndex = INDEX_NONE;
+	int32 EventIndex = INDEX_NONE;
+	uint32 EventGeneration = 0;
+	uint32 Generation = 0;
+};
+
+/**
+ * Generation checked handle to a timeline in UPlayMontageProSubsystem's pool.
+ * Resolves to nullptr once the timeline is released, even if its slot has since been reused.
+ */
+struct PLAYMONTAGEPRO_API FAnimNotifyProTimelineHandle
+{
+	TWeakObjectPtr<UPlayMontageProSubsystem> Subsystem;
+	int32 Index = INDEX_NONE;
+	uint32 Generation = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	/** @return The timeline, or nullptr if it has been released */
+	FAnimNotifyProTimeline* Get() const;
+};
+
 /**
  * Parameters for Pro notifies, which trigger reliably unlike Epic's notify system.
  * Contains options for enabling Pro notifies, triggering notifies before the starting position,
@@ -168,7 +532,7 @@ struct PLAYMONTAGEPRO_API FProNotifyParams
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Notify, meta=(EditCondition="bEnableProNotifies", EditConditionHides))
 	bool bTriggerNotifiesBeforeStartTime = false;
 
-	/** Whether to enable custom time dilation for the montage. Requires the mesh component to tick pose. May have additional performance overhead */
+	/** Whether to enable custom time dilation for the montage. Change it with SetActorCustomTimeDilation, or enable PlayMontagePro.PollTimeDilation if it is set directly */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Notify, meta=(EditCondition="bEnableProNotifies", EditConditionHides))
 	bool bEnableCustomTimeDilation = false;
 };
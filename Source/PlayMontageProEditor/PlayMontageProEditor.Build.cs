@@ -19,6 +19,7 @@ public class PlayMontageProEditor : ModuleRules
             {
                 "CoreUObject",
                 "Engine",
+                "UnrealEd",
                 "PlayMontagePro",
             }
         );
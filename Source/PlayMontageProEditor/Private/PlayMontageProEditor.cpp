@@ -1,15 +1,101 @@
 ﻿#include "PlayMontageProEditor.h"
 
+#include "Editor.h"
+#include "PlayMontageProNotifyTable.h"
+#include "PlayMontageProScheduleCache.h"
+#include "PlayMontageProStatics.h"
+#include "Animation/AnimMontage.h"
+#include "Subsystems/ImportSubsystem.h"
+#include "UObject/ObjectSaveContext.h"
+
 #define LOCTEXT_NAMESPACE "FPlayMontageProEditorModule"
 
 void FPlayMontageProEditorModule::StartupModule()
 {
-    
+    FCoreDelegates::OnPostEngineInit.AddRaw(this, &FPlayMontageProEditorModule::OnPostEngineInit);
+    FCoreUObjectDelegates::OnObjectPreSave.AddRaw(this, &FPlayMontageProEditorModule::OnObjectPreSave);
 }
 
 void FPlayMontageProEditorModule::ShutdownModule()
 {
-    
+    FCoreDelegates::OnPostEngineInit.RemoveAll(this);
+    FCoreUObjectDelegates::OnObjectPreSave.RemoveAll(this);
+
+    if (GEditor && AssetReimportHandle.IsValid())
+    {
+        if (UImportSubsystem* ImportSubsystem = GEditor->GetEditorSubsystem<UImportSubsystem>())
+        {
+            ImportSubsystem->OnAssetReimport.Remove(AssetReimportHandle);
+        }
+    }
+}
+
+void FPlayMontageProEditorModule::OnPostEngineInit()
+{
+    // Reimporting replaces the montage data without going through PostEditChangeProperty
+    if (GEditor)
+    {
+        if (UImportSubsystem* ImportSubsystem = GEditor->GetEditorSubsystem<UImportSubsystem>())
+        {
+            AssetReimportHandle = ImportSubsystem->OnAssetReimport.AddRaw(this, &FPlayMontageProEditorModule::OnAssetReimport);
+        }
+    }
+}
+
+void FPlayMontageProEditorModule::OnAssetReimport(UObject* Asset)
+{
+    if (const UAnimMontage* Montage = Cast<UAnimMontage>(Asset))
+    {
+        if (UPlayMontageProScheduleCache* Cache = UPlayMontageProScheduleCache::Get())
+        {
+            Cache->InvalidateSchedule(Montage);
+        }
+    }
+}
+
+void FPlayMontageProEditorModule::OnObjectPreSave(UObject* Object, FObjectPreSaveContext SaveContext)
+{
+    UAnimMontage* Montage = Cast<UAnimMontage>(Object);
+    if (!Montage || Montage->HasAnyFlags(RF_ClassDefaultObject))
+    {
+        return;
+    }
+
+    // Only cooked builds read the table, baking on every editor save would churn the source asset
+    if (!SaveContext.IsCooking())
+    {
+        // Don't let a table left over from cooking in the editor be saved into the source asset
+        if (Montage->GetAssetUserData<UPlayMontageProNotifyTable>())
+        {
+            Montage->RemoveUserDataOfClass(UPlayMontageProNotifyTable::StaticClass());
+        }
+        return;
+    }
+
+    // Bake the schedule onto the montage so cooked builds don't need to scan and cast its notifies
+    FAnimNotifyProSchedule Schedule;
+    UPlayMontageProStatics::BuildNotifySchedule(Montage, Schedule);
+
+    UPlayMontageProNotifyTable* Table = Montage->GetAssetUserData<UPlayMontageProNotifyTable>();
+    if (Schedule.IsEmpty())
+    {
+        // No Pro notifies, don't leave a stale table behind
+        if (Table)
+        {
+            Montage->RemoveUserDataOfClass(UPlayMontageProNotifyTable::StaticClass());
+        }
+        return;
+    }
+
+    if (!Table)
+    {
+        Table = NewObject<UPlayMontageProNotifyTable>(Montage);
+        Montage->AddAssetUserData(Table);
+    }
+
+    Table->Version = UPlayMontageProNotifyTable::LatestVersion;
+    Table->NotifyHash = UPlayMontageProNotifyTable::HashNotifies(Montage);
+    Table->Schedule = MoveTemp(Schedule);
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -3,9 +3,18 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+class FObjectPreSaveContext;
+
 class FPlayMontageProEditorModule : public IModuleInterface
 {
 public:
     virtual void StartupModule() override;
     virtual void ShutdownModule() override;
+
+protected:
+    void OnPostEngineInit();
+    void OnAssetReimport(UObject* Asset);
+    void OnObjectPreSave(UObject* Object, FObjectPreSaveContext SaveContext);
+
+    FDelegateHandle AssetReimportHandle;
 };